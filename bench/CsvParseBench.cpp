@@ -0,0 +1,217 @@
+// Micro-benchmark do parsing de linhas CSV do CsvDisciplinaRepository:
+// caminho antigo (splitCsv com std::string por coluna + trim + stoi/stod)
+// contra o CsvTokenizer (string_view + from_chars).
+//
+// As linhas saem das inclusões dos roteiros em exemplos/*.in, repetidas
+// até N linhas (padrão 1.000.000), e ficam em memória: mede só o parsing,
+// não o disco.
+//
+// uso: bench_csv_parse [linhas] [diretorio-exemplos]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CsvTokenizer.hpp"
+#include "Disciplina.hpp"
+#include "Errors.hpp"
+#include "Uteis.hpp"
+
+#ifndef BENCH_EXEMPLOS_DIR
+  #define BENCH_EXEMPLOS_DIR "exemplos"
+#endif
+
+namespace {
+
+// ---------- caminho antigo (cópia do que o repositório fazia) ----------
+
+std::vector<std::string> splitCsvAntigo(const std::string& line)
+{
+    std::vector<std::string> cols;
+    std::string current;
+
+    for (char c : line)
+    {
+        if (c == ',')
+        {
+            cols.push_back(trim(current));
+            current.clear();
+        }
+        else
+        {
+            current.push_back(c);
+        }
+    }
+
+    cols.push_back(trim(current));
+    return cols;
+}
+
+Disciplina csvToDisciplinaAntigo(const std::string& line, int id)
+{
+    auto cols = splitCsvAntigo(line);
+
+    if (cols.size() != 7)
+        throw ConversionError("Linha CSV invalida: quantidade de colunas diferente de 7.");
+
+    Disciplina d;
+    d.setId(id);
+    d.setMatricula(cols[0]);
+    d.setNome(cols[1]);
+
+    try
+    {
+        d.setSemestre(std::stoi(cols[2]));
+        d.setAno(std::stoi(cols[3]));
+        d.setCreditos(std::stoi(cols[4]));
+        d.setNota1(std::stod(cols[5]));
+        d.setNota2(std::stod(cols[6]));
+    }
+    catch (...)
+    {
+        throw ConversionError("Falha ao converter campos numericos do CSV de disciplina.");
+    }
+
+    return d;
+}
+
+// ---------- caminho novo ----------
+
+// o próprio parsing do repositório (CsvTokenizer), não uma cópia
+Disciplina csvToDisciplinaNovo(const std::string& line, int id)
+{
+    return csvToDisciplina(line, id);
+}
+
+// ---------- dados ----------
+
+// Inclusões dos roteiros: "1", nome, matrícula, créditos, ano, semestre,
+// nota1, nota2.
+std::vector<std::string> linhasDosExemplos(const std::string& dir)
+{
+    std::vector<std::string> out;
+
+    std::vector<std::filesystem::path> arquivos;
+    for (const auto& e : std::filesystem::directory_iterator(dir))
+        if (e.path().extension() == ".in")
+            arquivos.push_back(e.path());
+    std::sort(arquivos.begin(), arquivos.end());
+
+    for (const auto& p : arquivos)
+    {
+        std::ifstream in(p);
+        std::vector<std::string> l;
+        std::string s;
+        while (std::getline(in, s))
+        {
+            if (!s.empty() && s.back() == '\r')
+                s.pop_back();
+            l.push_back(s);
+        }
+
+        for (size_t i = 0; i + 7 < l.size(); ++i)
+        {
+            int creditos, ano, semestre;
+            double n1, n2;
+            if (l[i] != "1" ||
+                !parseCsvInt(l[i + 3], creditos) || !parseCsvInt(l[i + 4], ano) ||
+                !parseCsvInt(l[i + 5], semestre) ||
+                !parseCsvDouble(l[i + 6], n1) || !parseCsvDouble(l[i + 7], n2))
+                continue;
+
+            std::ostringstream oss;
+            writeCsvField(oss, l[i + 2]);
+            oss << ',';
+            writeCsvField(oss, l[i + 1]);
+            oss << ',' << semestre << ',' << ano << ',' << creditos << ','
+                << std::fixed << std::setprecision(2) << n1 << ',' << n2;
+            out.push_back(oss.str());
+            i += 7;
+        }
+    }
+    return out;
+}
+
+struct Resultado
+{
+    double ms = 0.0;
+    double soma = 0.0;   // impede que o compilador descarte o trabalho
+};
+
+template <typename F>
+Resultado medir(const std::vector<std::string>& linhas, F parse)
+{
+    Resultado melhor;
+    for (int rodada = 0; rodada < 3; ++rodada)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        double soma = 0.0;
+        int id = 0;
+        for (const auto& l : linhas)
+        {
+            const Disciplina d = parse(l, ++id);
+            soma += d.getNota1() + d.getNota2() + d.getCreditos()
+                  + static_cast<double>(d.getNome().size() + d.getMatricula().size());
+        }
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (rodada == 0 || ms < melhor.ms)
+            melhor.ms = ms;
+        melhor.soma = soma;
+    }
+    return melhor;
+}
+
+void imprimir(const char* nome, const Resultado& r, size_t linhas, size_t bytes)
+{
+    std::printf("%-28s %9.1f ms  %7.1f ns/linha  %7.1f MB/s\n",
+                nome, r.ms, r.ms * 1e6 / static_cast<double>(linhas),
+                static_cast<double>(bytes) / (r.ms / 1000.0) / 1e6);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    const size_t total = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const std::string dir = argc > 2 ? argv[2] : BENCH_EXEMPLOS_DIR;
+
+    const auto base = linhasDosExemplos(dir);
+    if (base.empty())
+    {
+        std::fprintf(stderr, "nenhuma inclusao encontrada em %s/*.in\n", dir.c_str());
+        return 1;
+    }
+
+    std::vector<std::string> linhas;
+    linhas.reserve(total);
+    size_t bytes = 0;
+    for (size_t i = 0; i < total; ++i)
+    {
+        linhas.push_back(base[i % base.size()]);
+        bytes += linhas.back().size() + 1;
+    }
+
+    std::printf("%zu linhas (%zu distintas dos exemplos), %.1f MB\n",
+                linhas.size(), base.size(), static_cast<double>(bytes) / 1e6);
+
+    const Resultado antigo = medir(linhas, csvToDisciplinaAntigo);
+    const Resultado novo = medir(linhas, csvToDisciplinaNovo);
+
+    imprimir("splitCsv + stoi/stod", antigo, linhas.size(), bytes);
+    imprimir("CsvTokenizer + from_chars", novo, linhas.size(), bytes);
+    std::printf("ganho: %.2fx\n", antigo.ms / novo.ms);
+
+    if (antigo.soma != novo.soma)
+    {
+        std::fprintf(stderr, "resultados diferentes: %.6f != %.6f\n", antigo.soma, novo.soma);
+        return 1;
+    }
+    return 0;
+}
@@ -24,6 +24,39 @@ public:
     const std::string& getLogType() const;
     const std::string& getWebPathRoot() const;
     int getWebPort() const;
+    int getWebThreads() const;
+    const std::string& getWebIoMode() const;
+    int getWebKeepAliveTimeout() const;
+    int getWebKeepAliveMax() const;
+    bool isWebCacheRefresh() const;
+    int getWebCacheMaxFile() const;
+
+    // Perfil de desempenho do SQLite (PRAGMAs aplicados ao abrir o banco)
+    const std::string& getSqliteJournalMode() const;
+    const std::string& getSqliteSynchronous() const;
+    long long getSqliteMmapSize() const;
+    int getSqliteCacheSize() const;
+    const std::string& getSqliteTempStore() const;
+    int getSqliteReadConnections() const;
+
+    // Repositório binário: STREAM (padrão; abre o arquivo a cada operação)
+    // ou MMAP; msync depois das gravações: NONE, ASYNC ou SYNC
+    const std::string& getBinStorage() const;
+    const std::string& getBinMsync() const;
+    // Buffer de escrita do modo STREAM: grava ao juntar BIN_FLUSH_BYTES ou
+    // a cada BIN_FLUSH_INTERVAL_MS. Bytes = 0 desliga o buffer; intervalo
+    // = 0 deixa só o gatilho de tamanho (e o flush explícito)
+    int getBinFlushBytes() const;
+    int getBinFlushIntervalMs() const;
+
+    // Repositório CSV: REWRITE (update/remove regravam o arquivo) ou LOG
+    // (acrescentam a operação); compacta quando as linhas mortas passam de
+    // CSV_COMPACT_PERCENT % dos registros (0 = só compactação explícita)
+    const std::string& getCsvStorage() const;
+    int getCsvCompactPercent() const;
+    // Threads da carga paralela do CSV (list); 0 = núcleos da máquina,
+    // 1 = carga sequencial
+    int getCsvLoadThreads() const;
 
 private:
     bool verbose;
@@ -50,6 +83,63 @@ private:
     int webPort;
     bool webPortDefinida;
 
+    int webThreads;
+    bool webThreadsDefinida;
+
+    std::string webIoMode;
+    bool webIoModeDefinido;
+
+    int webKeepAliveTimeout;
+    bool webKeepAliveTimeoutDefinido;
+
+    int webKeepAliveMax;
+    bool webKeepAliveMaxDefinido;
+
+    bool webCacheRefresh;
+    bool webCacheRefreshDefinido;
+
+    int webCacheMaxFile;
+    bool webCacheMaxFileDefinido;
+
+    std::string sqliteJournalMode;
+    bool sqliteJournalModeDefinido;
+
+    std::string sqliteSynchronous;
+    bool sqliteSynchronousDefinido;
+
+    long long sqliteMmapSize;
+    bool sqliteMmapSizeDefinido;
+
+    int sqliteCacheSize;
+    bool sqliteCacheSizeDefinido;
+
+    std::string sqliteTempStore;
+    bool sqliteTempStoreDefinido;
+
+    int sqliteReadConnections;
+    bool sqliteReadConnectionsDefinido;
+
+    std::string binStorage;
+    bool binStorageDefinido;
+
+    std::string binMsync;
+    bool binMsyncDefinido;
+
+    int binFlushBytes;
+    bool binFlushBytesDefinido;
+
+    int binFlushIntervalMs;
+    bool binFlushIntervalMsDefinido;
+
+    std::string csvStorage;
+    bool csvStorageDefinido;
+
+    int csvCompactPercent;
+    bool csvCompactPercentDefinido;
+
+    int csvLoadThreads;
+    bool csvLoadThreadsDefinido;
+
     void carregarDeAmbiente();
     void carregarDeArquivo(const std::string& path);
     void carregarDeArgumentos(int argc, char* argv[]);
@@ -0,0 +1,42 @@
+#ifndef _THREAD_POOL_HPP_
+#define _THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool fixo de threads de trabalho.
+//
+// - As tarefas são executadas na ordem em que foram submetidas (fila FIFO).
+// - Exceções lançadas por uma tarefa são descartadas: quem submete deve
+//   tratar os próprios erros dentro da tarefa.
+// - O destrutor espera as tarefas pendentes terminarem antes de retornar.
+
+class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Enfileira uma tarefa para ser executada por alguma thread do pool.
+        void submit(std::function<void()> task);
+
+        std::size_t size() const;
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool stopping;
+
+        void workerLoop();
+};
+
+#endif
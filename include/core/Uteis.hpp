@@ -1,11 +1,25 @@
 #ifndef _UTEIS_HPP_
 #define _UTEIS_HPP_
 
+#include <cstdint>
 #include <string>
+#include <system_error>
 
 std::string trim(const std::string& s);
 std::string toUpper(std::string s);
 std::string changeExtension(const std::string& fileName, const std::string& extensao);
 std::string joinPath(const std::string& dir, const std::string& file);
 
+// Marca de versão de um arquivo (mtime + tamanho): muda quando o arquivo é
+// regravado, por este processo ou por outro. Nunca é 0; arquivo ausente = 1.
+std::uint64_t fileRevision(const std::string& path);
+
+// fsync (_commit no Windows) de um arquivo já gravado, pelo caminho.
+std::error_code syncFile(const std::string& path);
+
+// Troca 'path' pelo temporário 'tmp' já fechado: fsync do temporário,
+// rename e fsync do diretório, para uma queda no meio deixar o arquivo
+// antigo ou o novo inteiro (nunca vazio ou pela metade).
+std::error_code durableReplace(const std::string& tmp, const std::string& path);
+
 #endif
@@ -0,0 +1,56 @@
+#ifndef _DISCIPLINA_ESTATISTICAS_HPP_
+#define _DISCIPLINA_ESTATISTICAS_HPP_
+
+#include <array>
+#include <vector>
+#include "Disciplina.hpp"
+
+// Agregados do histórico por período (ano, semestre) e acumulados.
+//
+// - media = (nota1 + nota2) / 2; CR = soma(media * creditos) / soma(creditos),
+//   considerando só disciplinas com créditos > 0 (mesma regra do calculateCR).
+// - distribuicao[i] conta as médias em [i, i+1); a faixa 9 inclui o 10.
+// - periodos vem em ordem crescente de (ano, semestre); 'acumulado' soma o
+//   período com todos os anteriores (o CR acumulado ao fim de cada semestre).
+
+struct EstatisticasGrupo {
+    int    disciplinas = 0;
+    int    creditos = 0;          // soma dos créditos (> 0)
+    double somaPonderada = 0.0;   // soma de media * creditos
+    double somaMedias = 0.0;      // soma das médias (para a média simples)
+    double mediaMin = 0.0;        // válidos só com disciplinas > 0
+    double mediaMax = 0.0;
+    std::array<int, 10> distribuicao{};
+
+    double cr() const { return creditos > 0 ? somaPonderada / creditos : 0.0; }
+    double mediaSimples() const { return disciplinas > 0 ? somaMedias / disciplinas : 0.0; }
+};
+
+struct EstatisticasPeriodo {
+    int ano = 0;
+    int semestre = 0;
+    EstatisticasGrupo periodo;
+    EstatisticasGrupo acumulado;
+};
+
+struct DisciplinaEstatisticas {
+    std::vector<EstatisticasPeriodo> periodos;
+    EstatisticasGrupo geral;
+};
+
+// Faixa da distribuição (0..9) de uma média.
+int faixaDistribuicao(double media);
+
+// Inclui uma disciplina no grupo.
+void accumulate(EstatisticasGrupo& g, const Disciplina& d);
+// Soma dois grupos (ex.: períodos -> acumulado).
+void merge(EstatisticasGrupo& into, const EstatisticasGrupo& from);
+
+// Uma passada sobre 'all': usada como padrão pelos repositórios que não
+// conseguem agregar na origem (SQL).
+DisciplinaEstatisticas computeEstatisticas(const std::vector<Disciplina>& all);
+
+// Preenche 'acumulado' e 'geral' a partir de 'periodos' já ordenados.
+void fillAcumulados(DisciplinaEstatisticas& e);
+
+#endif
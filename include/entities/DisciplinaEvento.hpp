@@ -0,0 +1,24 @@
+#ifndef _DISCIPLINA_EVENTO_HPP_
+#define _DISCIPLINA_EVENTO_HPP_
+
+#include "Disciplina.hpp"
+
+// Alteração no histórico, notificada pelo service aos observadores
+// (ver IHistoricoService::setChangeListener).
+//
+// - Insert/Update: 'disciplina' traz o registro já gravado (com média).
+// - Remove: só o 'id'.
+// - Reset: houve alterações que não cabem num delta simples (lote, ou
+//   remoção que renumerou ids nos repositórios posicionais); quem observa
+//   deve recarregar a lista.
+// Todos trazem o CR já recalculado.
+struct DisciplinaEvento {
+    enum class Tipo { Insert, Update, Remove, Reset };
+
+    Tipo       tipo = Tipo::Reset;
+    int        id   = 0;
+    Disciplina disciplina;
+    double     cr   = 0.0;
+};
+
+#endif
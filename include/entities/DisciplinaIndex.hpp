@@ -0,0 +1,75 @@
+#ifndef _DISCIPLINA_INDEX_HPP_
+#define _DISCIPLINA_INDEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Disciplina.hpp"
+
+// Índice em memória da chave de negócio (matricula, ano, semestre) -> id.
+//
+// - Usado pelos repositórios para responder exist() em O(1), sem varrer o
+//   arquivo. Guarda também id -> chave, para que update/remove tirem a
+//   chave antiga sem reler o registro.
+// - O índice é carimbado com a revision() do repositório em que ficou em
+//   dia. Gravações do próprio repositório aplicam só a diferença e
+//   recarimbam (afterWrite); uma gravação feita por fora muda a revisão e
+//   o repositório reconstrói o índice na próxima consulta.
+// - Não é thread-safe: segue as mesmas regras do repositório que o usa.
+
+class DisciplinaIndex {
+    public:
+        // true se o índice reflete os dados na revisão 'rev' (0 = nunca)
+        bool isCurrent(std::uint64_t rev) const { return valido && rev != 0 && rev == revisao; }
+
+        void rebuild(const std::vector<Disciplina>& all, std::uint64_t rev);
+        void invalidate() { valido = false; }
+
+        // Depois de uma gravação já refletida no índice: recarimba com 'rev'
+        // se o índice estava em dia antes dela, senão descarta.
+        void afterWrite(bool estavaEmDia, std::uint64_t rev);
+
+        // id da disciplina com a chave, ou 0 se não há
+        int find(const std::string& matricula, int ano, int semestre) const;
+
+        void onInsert(int id, const Disciplina& d);
+        void onUpdate(int id, const Disciplina& d);
+        void onRemove(int id);
+        // Repositórios posicionais: o último registro (lastId) passa a
+        // ocupar o id removido.
+        void onRemoveSwapLast(int id, int lastId);
+
+        std::size_t size() const { return porChave.size(); }
+
+    private:
+        struct Chave {
+            std::string matricula;
+            int ano = 0;
+            int semestre = 0;
+
+            bool operator==(const Chave& o) const {
+                return ano == o.ano && semestre == o.semestre && matricula == o.matricula;
+            }
+        };
+
+        struct ChaveHash {
+            std::size_t operator()(const Chave& c) const;
+        };
+
+        static Chave chaveDe(const Disciplina& d);
+
+        std::unordered_map<Chave, int, ChaveHash> porChave;
+        std::unordered_map<int, Chave> porId;
+        // Chave repetida (só se o arquivo foi alterado por fora): porChave
+        // fica com o primeiro id e os demais ficam aqui, para a chave não
+        // sumir do índice quando o primeiro sair
+        std::unordered_multimap<Chave, int, ChaveHash> repetidas;
+        bool valido = false;
+        std::uint64_t revisao = 0;
+
+        void erase(int id);
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef _DISCIPLINA_OPERACAO_HPP_
+#define _DISCIPLINA_OPERACAO_HPP_
+
+#include "Disciplina.hpp"
+
+// Uma operação de um lote (ver IHistoricoService::applyBatch).
+struct DisciplinaOperacao {
+    enum class Tipo { Insert, Update, Remove };
+
+    Tipo       tipo = Tipo::Insert;
+    int        id   = 0;       // Update / Remove
+    Disciplina disciplina;     // Insert / Update
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef _DISCIPLINA_QUERY_HPP_
+#define _DISCIPLINA_QUERY_HPP_
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "Disciplina.hpp"
+
+// Consulta filtrada, ordenada e paginada sobre as disciplinas.
+//
+// - Filtros não informados (string vazia / std::nullopt) não restringem.
+// - matricula: igualdade exata; nome: trecho do nome, sem diferenciar
+//   maiúsculas/minúsculas.
+// - mediaMin/mediaMax: intervalo fechado sobre (nota1 + nota2) / 2.
+// - A ordenação sempre desempata pelo id, para que a paginação seja estável.
+// - limit < 0 significa "sem limite".
+
+enum class DisciplinaSort { Id, Matricula, Nome, Ano, Semestre, Creditos, Media };
+
+struct DisciplinaQuery {
+    std::string           matricula;
+    std::string           nome;
+    std::optional<int>    ano;
+    std::optional<int>    semestre;
+    std::optional<double> mediaMin;
+    std::optional<double> mediaMax;
+
+    DisciplinaSort sort = DisciplinaSort::Id;
+    bool           desc = false;
+
+    int limit  = -1;
+    int offset = 0;
+};
+
+struct DisciplinaPage {
+    std::vector<Disciplina> items;
+    int total = 0;   // quantidade que atende aos filtros (antes de limit/offset)
+};
+
+// Implementação em memória da consulta: usada como padrão pelos
+// repositórios que não têm um meio melhor (SQL, índice, ...).
+bool matchesQuery(const Disciplina& d, const DisciplinaQuery& q);
+DisciplinaPage applyQuery(std::vector<Disciplina> all, const DisciplinaQuery& q);
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef _IDISCIPLINA_REPOSITORY_HPP_
 #define _IDISCIPLINA_REPOSITORY_HPP_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include "Disciplina.hpp"
+#include "DisciplinaQuery.hpp"
+#include "DisciplinaEstatisticas.hpp"
 
 // Interface de acesso a dados para Disciplina.
 //
@@ -44,6 +47,23 @@ class IDisciplinaRepository {
         // As disciplinas retornadas devem conter seus ids técnicos válidos.
         virtual std::vector<Disciplina> list() const = 0;
 
+        // Retorna só a página das disciplinas que atendem aos filtros de 'q',
+        // já ordenada, e o total de disciplinas que atendem aos filtros.
+        //
+        // A implementação padrão filtra em memória o resultado de list();
+        // repositórios que consigam fazer melhor (SQL, índices) sobrescrevem.
+        virtual DisciplinaPage query(const DisciplinaQuery& q) const {
+            return applyQuery(list(), q);
+        }
+
+        // Agregados por período e acumulados (ver DisciplinaEstatisticas).
+        //
+        // A implementação padrão faz uma passada sobre list(); repositórios
+        // que consigam agregar na origem (GROUP BY) sobrescrevem.
+        virtual DisciplinaEstatisticas statistics() const {
+            return computeEstatisticas(list());
+        }
+
         // Verifica se existe alguma disciplina cadastrada com a combinação
         // (matricula, ano, semestre).
         //
@@ -55,6 +75,33 @@ class IDisciplinaRepository {
         //
         // Usado pela camada de serviço para validar se existe ou nao de negócio.
         virtual bool exist(int id) const = 0;
+
+        // Lote de gravações: entre beginBatch e commitBatch o repositório pode
+        // manter as alterações em memória e gravá-las uma única vez no commit;
+        // rollbackBatch descarta o que ainda não foi gravado.
+        //
+        // O padrão não faz nada (cada operação é gravada na hora). Não há
+        // lotes aninhados.
+        virtual void beginBatch() {}
+        virtual void commitBatch() {}
+        virtual void rollbackBatch() {}
+
+        // Grava o que o repositório ainda guarda em buffer e força os dados
+        // para o disco (fsync). Chamado depois de um lote confirmado e no
+        // encerramento do programa.
+        //
+        // O padrão não faz nada (cada operação já é gravada na hora).
+        virtual void flush() {}
+
+        // Marca de versão dos dados persistidos: muda a cada gravação feita
+        // por este repositório e, quando o meio permite detectar (mtime do
+        // arquivo, data_version do SQLite), também a cada gravação feita por
+        // fora. Usada pela camada de serviço para saber quando um agregado
+        // mantido em memória (ex.: o CR) deixou de valer.
+        //
+        // 0 = o repositório não sabe dizer: quem usa deve considerar que
+        // os dados sempre mudaram.
+        virtual std::uint64_t revision() const { return 0; }
 };
 
 #endif
\ No newline at end of file
@@ -1,8 +1,13 @@
 #ifndef _IHISTORICO_SERVICE_HPP_
 #define _IHISTORICO_SERVICE_HPP_
 
+#include <functional>
 #include <vector>
 #include "Disciplina.hpp"
+#include "DisciplinaQuery.hpp"
+#include "DisciplinaOperacao.hpp"
+#include "DisciplinaEvento.hpp"
+#include "DisciplinaEstatisticas.hpp"
 
 // Interface de regras de negócio para o histórico acadêmico.
 //
@@ -23,6 +28,8 @@
 
 class IHistoricoService {
     public:
+        using ChangeListener = std::function<void(const DisciplinaEvento&)>;
+
         virtual ~IHistoricoService() = default;
 
         // Adiciona uma nova disciplina ao histórico.
@@ -37,6 +44,19 @@ class IHistoricoService {
         // Remove uma disciplina existente pelo id técnico.
         virtual void remove(int id) = 0;
 
+        // Aplica um lote de inclusões, alterações e remoções como uma unidade:
+        // - todas as validações (inclusive unicidade, considerando o efeito das
+        //   demais operações do lote) são feitas antes de qualquer gravação;
+        //   se uma falhar, nada é gravado (BusinessError com o nº da operação);
+        // - o repositório grava uma vez só (beginBatch/commitBatch).
+        // Os ids informados se referem ao estado anterior ao lote; por isso as
+        // operações são aplicadas na ordem: alterações, remoções, inclusões.
+        // Retorna, na ordem de 'ops', o id de cada disciplina depois do lote:
+        // o atribuído, nas inclusões; o final, nas alterações (em repositórios
+        // posicionais uma remoção no mesmo lote pode mudá-lo); nas remoções,
+        // o id removido (anterior ao lote).
+        virtual std::vector<int> applyBatch(const std::vector<DisciplinaOperacao>& ops) = 0;
+
         // Obtém uma disciplina específica pelo id técnico.
         // Deve lançar exceção se não encontrada.
         virtual Disciplina get(int id) const = 0;
@@ -46,10 +66,26 @@ class IHistoricoService {
         // a partir desta lista, se desejado.
         virtual std::vector<Disciplina> list() const = 0;
 
+        // Lista uma página de disciplinas filtrada e ordenada
+        // (ver DisciplinaQuery). O trabalho é delegado ao repositório, para
+        // que o custo acompanhe o tamanho da página e não o do histórico.
+        virtual DisciplinaPage query(const DisciplinaQuery& q) const = 0;
+
         // Calcula o coeficiente de rendimento (CR) com base
         // nas disciplinas válidas cadastradas.
         // A regra exata de cálculo é documentada na implementação.
         virtual double calculateCR() const = 0;
+
+        // CR, créditos, quantidade e distribuição das médias por período
+        // (ano, semestre) e acumulados até cada período, numa chamada só
+        // (ver DisciplinaEstatisticas). Agregado no repositório.
+        virtual DisciplinaEstatisticas statistics() const = 0;
+
+        // Registra o observador de alterações (um só; nullptr remove).
+        // É chamado após cada insert/update/remove/applyBatch bem-sucedido,
+        // na thread que fez a alteração: deve ser rápido e não chamar o
+        // service de volta.
+        virtual void setChangeListener(ChangeListener listener) = 0;
 };
 
 #endif
\ No newline at end of file
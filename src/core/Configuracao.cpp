@@ -21,6 +21,25 @@ Configuracao::Configuracao(int argc,
     , logType("file")                   , logTypeDefinida(false) 
     , webPathRoot("www")                , webPathRootDefinida(false)
     , webPort(9090)                     , webPortDefinida(false)
+    , webThreads(4)                     , webThreadsDefinida(false)
+    , webIoMode("threads")              , webIoModeDefinido(false)
+    , webKeepAliveTimeout(5)            , webKeepAliveTimeoutDefinido(false)
+    , webKeepAliveMax(100)              , webKeepAliveMaxDefinido(false)
+    , webCacheRefresh(false)            , webCacheRefreshDefinido(false)
+    , webCacheMaxFile(262144)           , webCacheMaxFileDefinido(false)
+    , sqliteJournalMode("WAL")          , sqliteJournalModeDefinido(false)
+    , sqliteSynchronous("NORMAL")       , sqliteSynchronousDefinido(false)
+    , sqliteMmapSize(64LL * 1024 * 1024), sqliteMmapSizeDefinido(false)
+    , sqliteCacheSize(-8192)            , sqliteCacheSizeDefinido(false)
+    , sqliteTempStore("MEMORY")         , sqliteTempStoreDefinido(false)
+    , sqliteReadConnections(4)          , sqliteReadConnectionsDefinido(false)
+    , binStorage("STREAM")              , binStorageDefinido(false)
+    , binMsync("NONE")                  , binMsyncDefinido(false)
+    , binFlushBytes(65536)              , binFlushBytesDefinido(false)
+    , binFlushIntervalMs(100)           , binFlushIntervalMsDefinido(false)
+    , csvStorage("REWRITE")             , csvStorageDefinido(false)
+    , csvCompactPercent(50)             , csvCompactPercentDefinido(false)
+    , csvLoadThreads(0)                 , csvLoadThreadsDefinido(false)
 {
     // 1) Ambiente
     carregarDeAmbiente();
@@ -72,6 +91,82 @@ int Configuracao::getWebPort() const
 {
     return webPort;
 }
+int Configuracao::getWebThreads() const
+{
+    return webThreads;
+}
+const std::string& Configuracao::getWebIoMode() const
+{
+    return webIoMode;
+}
+int Configuracao::getWebKeepAliveTimeout() const
+{
+    return webKeepAliveTimeout;
+}
+int Configuracao::getWebKeepAliveMax() const
+{
+    return webKeepAliveMax;
+}
+bool Configuracao::isWebCacheRefresh() const
+{
+    return webCacheRefresh;
+}
+int Configuracao::getWebCacheMaxFile() const
+{
+    return webCacheMaxFile;
+}
+const std::string& Configuracao::getSqliteJournalMode() const
+{
+    return sqliteJournalMode;
+}
+const std::string& Configuracao::getSqliteSynchronous() const
+{
+    return sqliteSynchronous;
+}
+long long Configuracao::getSqliteMmapSize() const
+{
+    return sqliteMmapSize;
+}
+int Configuracao::getSqliteCacheSize() const
+{
+    return sqliteCacheSize;
+}
+const std::string& Configuracao::getSqliteTempStore() const
+{
+    return sqliteTempStore;
+}
+int Configuracao::getSqliteReadConnections() const
+{
+    return sqliteReadConnections;
+}
+const std::string& Configuracao::getBinStorage() const
+{
+    return binStorage;
+}
+const std::string& Configuracao::getBinMsync() const
+{
+    return binMsync;
+}
+int Configuracao::getBinFlushBytes() const
+{
+    return binFlushBytes;
+}
+int Configuracao::getBinFlushIntervalMs() const
+{
+    return binFlushIntervalMs;
+}
+const std::string& Configuracao::getCsvStorage() const
+{
+    return csvStorage;
+}
+int Configuracao::getCsvCompactPercent() const
+{
+    return csvCompactPercent;
+}
+int Configuracao::getCsvLoadThreads() const
+{
+    return csvLoadThreads;
+}
 
 // --------------------------------------------
 // Fonte: Ambiente
@@ -181,6 +276,181 @@ void Configuracao::carregarDeAmbiente()
             webPortDefinida = true;
         }
     }
+    if (!webThreadsDefinida)
+    {
+        const char* v = std::getenv("WEB_THREADS");
+        if (v && *v)
+        {
+            webThreads = std::max(1, std::stoi( v ));
+            webThreadsDefinida = true;
+        }
+    }
+    if (!webIoModeDefinido)
+    {
+        const char* v = std::getenv("WEB_IO_MODE");
+        if (v && *v)
+        {
+            webIoMode = v;
+            webIoModeDefinido = true;
+        }
+    }
+    if (!webKeepAliveTimeoutDefinido)
+    {
+        const char* v = std::getenv("WEB_KEEPALIVE_TIMEOUT");
+        if (v && *v)
+        {
+            webKeepAliveTimeout = std::max(0, std::stoi(v));
+            webKeepAliveTimeoutDefinido = true;
+        }
+    }
+    if (!webKeepAliveMaxDefinido)
+    {
+        const char* v = std::getenv("WEB_KEEPALIVE_MAX");
+        if (v && *v)
+        {
+            webKeepAliveMax = std::max(1, std::stoi(v));
+            webKeepAliveMaxDefinido = true;
+        }
+    }
+    if (!webCacheRefreshDefinido)
+    {
+        if (const char* v = std::getenv("WEB_CACHE_REFRESH"))
+        {
+            bool ok = false;
+            bool b = parseBool(v, ok);
+            if (ok)
+            {
+                webCacheRefresh = b;
+                webCacheRefreshDefinido = true;
+            }
+        }
+    }
+    if (!webCacheMaxFileDefinido)
+    {
+        const char* v = std::getenv("WEB_CACHE_MAX_FILE");
+        if (v && *v)
+        {
+            webCacheMaxFile = std::max(0, std::stoi(v));
+            webCacheMaxFileDefinido = true;
+        }
+    }
+    if (!sqliteJournalModeDefinido)
+    {
+        const char* v = std::getenv("SQLITE_JOURNAL_MODE");
+        if (v && *v)
+        {
+            sqliteJournalMode = toUpper(v);
+            sqliteJournalModeDefinido = true;
+        }
+    }
+    if (!sqliteSynchronousDefinido)
+    {
+        const char* v = std::getenv("SQLITE_SYNCHRONOUS");
+        if (v && *v)
+        {
+            sqliteSynchronous = toUpper(v);
+            sqliteSynchronousDefinido = true;
+        }
+    }
+    if (!sqliteMmapSizeDefinido)
+    {
+        const char* v = std::getenv("SQLITE_MMAP_SIZE");
+        if (v && *v)
+        {
+            sqliteMmapSize = std::max(0LL, std::stoll(v));
+            sqliteMmapSizeDefinido = true;
+        }
+    }
+    if (!sqliteCacheSizeDefinido)
+    {
+        const char* v = std::getenv("SQLITE_CACHE_SIZE");
+        if (v && *v)
+        {
+            sqliteCacheSize = std::stoi(v);
+            sqliteCacheSizeDefinido = true;
+        }
+    }
+    if (!sqliteTempStoreDefinido)
+    {
+        const char* v = std::getenv("SQLITE_TEMP_STORE");
+        if (v && *v)
+        {
+            sqliteTempStore = toUpper(v);
+            sqliteTempStoreDefinido = true;
+        }
+    }
+    if (!sqliteReadConnectionsDefinido)
+    {
+        const char* v = std::getenv("SQLITE_READ_CONNECTIONS");
+        if (v && *v)
+        {
+            sqliteReadConnections = std::max(0, std::stoi(v));
+            sqliteReadConnectionsDefinido = true;
+        }
+    }
+    if (!binStorageDefinido)
+    {
+        const char* v = std::getenv("BIN_STORAGE");
+        if (v && *v)
+        {
+            binStorage = toUpper(v);
+            binStorageDefinido = true;
+        }
+    }
+    if (!binMsyncDefinido)
+    {
+        const char* v = std::getenv("BIN_MSYNC");
+        if (v && *v)
+        {
+            binMsync = toUpper(v);
+            binMsyncDefinido = true;
+        }
+    }
+    if (!binFlushBytesDefinido)
+    {
+        const char* v = std::getenv("BIN_FLUSH_BYTES");
+        if (v && *v)
+        {
+            binFlushBytes = std::max(0, std::stoi(v));
+            binFlushBytesDefinido = true;
+        }
+    }
+    if (!binFlushIntervalMsDefinido)
+    {
+        const char* v = std::getenv("BIN_FLUSH_INTERVAL_MS");
+        if (v && *v)
+        {
+            binFlushIntervalMs = std::max(0, std::stoi(v));
+            binFlushIntervalMsDefinido = true;
+        }
+    }
+    if (!csvStorageDefinido)
+    {
+        const char* v = std::getenv("CSV_STORAGE");
+        if (v && *v)
+        {
+            csvStorage = toUpper(v);
+            csvStorageDefinido = true;
+        }
+    }
+    if (!csvCompactPercentDefinido)
+    {
+        const char* v = std::getenv("CSV_COMPACT_PERCENT");
+        if (v && *v)
+        {
+            csvCompactPercent = std::max(0, std::stoi(v));
+            csvCompactPercentDefinido = true;
+        }
+    }
+    if (!csvLoadThreadsDefinido)
+    {
+        const char* v = std::getenv("CSV_LOAD_THREADS");
+        if (v && *v)
+        {
+            csvLoadThreads = std::max(0, std::stoi(v));
+            csvLoadThreadsDefinido = true;
+        }
+    }
 }
 
 // --------------------------------------------
@@ -336,4 +606,158 @@ void Configuracao::aplicarPar(const std::string& chave, const std::string& valor
             webPortDefinida = true;
         }
     }
+    else if (keyUpper == "WEB_THREADS" && !webThreadsDefinida)
+    {
+        if (!valor.empty())
+        {
+            webThreads = std::max(1, std::stoi(valor));
+            webThreadsDefinida = true;
+        }
+    }
+    else if (keyUpper == "WEB_IO_MODE" && !webIoModeDefinido)
+    {
+        if (!valor.empty())
+        {
+            webIoMode = valor;
+            webIoModeDefinido = true;
+        }
+    }
+    else if (keyUpper == "WEB_KEEPALIVE_TIMEOUT" && !webKeepAliveTimeoutDefinido)
+    {
+        if (!valor.empty())
+        {
+            webKeepAliveTimeout = std::max(0, std::stoi(valor));
+            webKeepAliveTimeoutDefinido = true;
+        }
+    }
+    else if (keyUpper == "WEB_KEEPALIVE_MAX" && !webKeepAliveMaxDefinido)
+    {
+        if (!valor.empty())
+        {
+            webKeepAliveMax = std::max(1, std::stoi(valor));
+            webKeepAliveMaxDefinido = true;
+        }
+    }
+    else if (keyUpper == "WEB_CACHE_REFRESH" && !webCacheRefreshDefinido)
+    {
+        bool ok = false;
+        bool b = parseBool(valor, ok);
+        if (ok)
+        {
+            webCacheRefresh = b;
+            webCacheRefreshDefinido = true;
+        }
+    }
+    else if (keyUpper == "WEB_CACHE_MAX_FILE" && !webCacheMaxFileDefinido)
+    {
+        if (!valor.empty())
+        {
+            webCacheMaxFile = std::max(0, std::stoi(valor));
+            webCacheMaxFileDefinido = true;
+        }
+    }
+    else if (keyUpper == "SQLITE_JOURNAL_MODE" && !sqliteJournalModeDefinido)
+    {
+        if (!valor.empty())
+        {
+            sqliteJournalMode = toUpper(valor);
+            sqliteJournalModeDefinido = true;
+        }
+    }
+    else if (keyUpper == "SQLITE_SYNCHRONOUS" && !sqliteSynchronousDefinido)
+    {
+        if (!valor.empty())
+        {
+            sqliteSynchronous = toUpper(valor);
+            sqliteSynchronousDefinido = true;
+        }
+    }
+    else if (keyUpper == "SQLITE_MMAP_SIZE" && !sqliteMmapSizeDefinido)
+    {
+        if (!valor.empty())
+        {
+            sqliteMmapSize = std::max(0LL, std::stoll(valor));
+            sqliteMmapSizeDefinido = true;
+        }
+    }
+    else if (keyUpper == "SQLITE_CACHE_SIZE" && !sqliteCacheSizeDefinido)
+    {
+        if (!valor.empty())
+        {
+            sqliteCacheSize = std::stoi(valor);
+            sqliteCacheSizeDefinido = true;
+        }
+    }
+    else if (keyUpper == "SQLITE_TEMP_STORE" && !sqliteTempStoreDefinido)
+    {
+        if (!valor.empty())
+        {
+            sqliteTempStore = toUpper(valor);
+            sqliteTempStoreDefinido = true;
+        }
+    }
+    else if (keyUpper == "SQLITE_READ_CONNECTIONS" && !sqliteReadConnectionsDefinido)
+    {
+        if (!valor.empty())
+        {
+            sqliteReadConnections = std::max(0, std::stoi(valor));
+            sqliteReadConnectionsDefinido = true;
+        }
+    }
+    else if (keyUpper == "BIN_STORAGE" && !binStorageDefinido)
+    {
+        if (!valor.empty())
+        {
+            binStorage = toUpper(valor);
+            binStorageDefinido = true;
+        }
+    }
+    else if (keyUpper == "BIN_MSYNC" && !binMsyncDefinido)
+    {
+        if (!valor.empty())
+        {
+            binMsync = toUpper(valor);
+            binMsyncDefinido = true;
+        }
+    }
+    else if (keyUpper == "BIN_FLUSH_BYTES" && !binFlushBytesDefinido)
+    {
+        if (!valor.empty())
+        {
+            binFlushBytes = std::max(0, std::stoi(valor));
+            binFlushBytesDefinido = true;
+        }
+    }
+    else if (keyUpper == "BIN_FLUSH_INTERVAL_MS" && !binFlushIntervalMsDefinido)
+    {
+        if (!valor.empty())
+        {
+            binFlushIntervalMs = std::max(0, std::stoi(valor));
+            binFlushIntervalMsDefinido = true;
+        }
+    }
+    else if (keyUpper == "CSV_STORAGE" && !csvStorageDefinido)
+    {
+        if (!valor.empty())
+        {
+            csvStorage = toUpper(valor);
+            csvStorageDefinido = true;
+        }
+    }
+    else if (keyUpper == "CSV_COMPACT_PERCENT" && !csvCompactPercentDefinido)
+    {
+        if (!valor.empty())
+        {
+            csvCompactPercent = std::max(0, std::stoi(valor));
+            csvCompactPercentDefinido = true;
+        }
+    }
+    else if (keyUpper == "CSV_LOAD_THREADS" && !csvLoadThreadsDefinido)
+    {
+        if (!valor.empty())
+        {
+            csvLoadThreads = std::max(0, std::stoi(valor));
+            csvLoadThreadsDefinido = true;
+        }
+    }
 }
@@ -0,0 +1,65 @@
+#include "ThreadPool.hpp"
+
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t threads)
+    : stopping(false)
+{
+    if (threads == 0)
+        threads = 1;
+
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+
+    for (auto& t : workers)
+        if (t.joinable())
+            t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+std::size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try {
+            task();
+        }
+        catch (...) {
+            // a tarefa é responsável por tratar seus próprios erros
+        }
+    }
+}
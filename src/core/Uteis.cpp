@@ -1,6 +1,16 @@
 #include "Uteis.hpp"
+#include <cerrno>
+#include <filesystem>
 #include <string>
 
+#ifdef _WIN32
+  #include <fcntl.h>
+  #include <io.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
 using namespace std;
 
 string trim(const string& s)
@@ -52,4 +62,67 @@ string joinPath(const string& dir, const string& file)
         return dir + file;
 
     return dir + "/" + file; // funciona em Windows e Unix
-}
\ No newline at end of file
+}
+
+uint64_t fileRevision(const string& path)
+{
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return 1;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return 1;
+
+    uint64_t rev = (uint64_t)mtime.time_since_epoch().count();
+    rev = rev * 1099511628211ull ^ (uint64_t)size;
+    return rev > 1 ? rev : 2;
+}
+
+error_code syncFile(const string& path)
+{
+    error_code ec;
+#ifdef _WIN32
+    int fd = ::_open(path.c_str(), _O_WRONLY | _O_BINARY);
+    if (fd < 0)
+        return error_code(errno, generic_category());
+    if (::_commit(fd) != 0)
+        ec = error_code(errno, generic_category());
+    ::_close(fd);
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return error_code(errno, generic_category());
+    if (::fsync(fd) != 0)
+        ec = error_code(errno, generic_category());
+    ::close(fd);
+#endif
+    return ec;
+}
+
+error_code durableReplace(const string& tmp, const string& path)
+{
+    error_code ec = syncFile(tmp);
+    if (ec)
+        return ec;
+#ifdef _WIN32
+    // sem fsync de diretório no Windows: o rename é o último passo
+    std::filesystem::rename(tmp, path, ec);
+#else
+    std::filesystem::rename(tmp, path, ec);
+    if (ec)
+        return ec;
+
+    // a entrada nova no diretório só é durável com o fsync dele
+    string dir = std::filesystem::path(path).parent_path().string();
+    if (dir.empty())
+        dir = ".";
+    int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0)
+        return error_code(errno, generic_category());
+    if (::fsync(dfd) != 0)
+        ec = error_code(errno, generic_category());
+    ::close(dfd);
+#endif
+    return ec;
+}
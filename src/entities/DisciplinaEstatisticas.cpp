@@ -0,0 +1,71 @@
+#include "DisciplinaEstatisticas.hpp"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+int faixaDistribuicao(double media)
+{
+    return std::clamp((int)media, 0, 9);
+}
+
+void accumulate(EstatisticasGrupo& g, const Disciplina& d)
+{
+    const double media = (d.getNota1() + d.getNota2()) / 2.0;
+
+    g.mediaMin = g.disciplinas == 0 ? media : std::min(g.mediaMin, media);
+    g.mediaMax = g.disciplinas == 0 ? media : std::max(g.mediaMax, media);
+    g.disciplinas++;
+    g.somaMedias += media;
+    g.distribuicao[faixaDistribuicao(media)]++;
+
+    const int creditos = d.getCreditos();
+    if (creditos > 0) {
+        g.creditos += creditos;
+        g.somaPonderada += media * creditos;
+    }
+}
+
+void merge(EstatisticasGrupo& into, const EstatisticasGrupo& from)
+{
+    if (from.disciplinas == 0)
+        return;
+    into.mediaMin = into.disciplinas == 0 ? from.mediaMin : std::min(into.mediaMin, from.mediaMin);
+    into.mediaMax = into.disciplinas == 0 ? from.mediaMax : std::max(into.mediaMax, from.mediaMax);
+    into.disciplinas   += from.disciplinas;
+    into.creditos      += from.creditos;
+    into.somaPonderada += from.somaPonderada;
+    into.somaMedias    += from.somaMedias;
+    for (size_t i = 0; i < into.distribuicao.size(); ++i)
+        into.distribuicao[i] += from.distribuicao[i];
+}
+
+DisciplinaEstatisticas computeEstatisticas(const std::vector<Disciplina>& all)
+{
+    // uma passada; o map já deixa os períodos em ordem
+    std::map<std::pair<int, int>, EstatisticasGrupo> porPeriodo;
+    for (const auto& d : all)
+        accumulate(porPeriodo[{d.getAno(), d.getSemestre()}], d);
+
+    DisciplinaEstatisticas e;
+    e.periodos.reserve(porPeriodo.size());
+    for (auto& [chave, grupo] : porPeriodo) {
+        EstatisticasPeriodo p;
+        p.ano = chave.first;
+        p.semestre = chave.second;
+        p.periodo = grupo;
+        e.periodos.push_back(p);
+    }
+    fillAcumulados(e);
+    return e;
+}
+
+void fillAcumulados(DisciplinaEstatisticas& e)
+{
+    EstatisticasGrupo acumulado;
+    for (auto& p : e.periodos) {
+        merge(acumulado, p.periodo);
+        p.acumulado = acumulado;
+    }
+    e.geral = acumulado;
+}
@@ -0,0 +1,117 @@
+#include "DisciplinaIndex.hpp"
+
+#include <functional>
+
+std::size_t DisciplinaIndex::ChaveHash::operator()(const Chave& c) const
+{
+    std::size_t h = std::hash<std::string>()(c.matricula);
+    // ano e semestre cabem juntos num inteiro (semestre é 1 ou 2)
+    h ^= std::hash<int>()(c.ano * 4 + c.semestre) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+DisciplinaIndex::Chave DisciplinaIndex::chaveDe(const Disciplina& d)
+{
+    return Chave{d.getMatricula(), d.getAno(), d.getSemestre()};
+}
+
+void DisciplinaIndex::rebuild(const std::vector<Disciplina>& all, std::uint64_t rev)
+{
+    porChave.clear();
+    porId.clear();
+    repetidas.clear();
+    porChave.reserve(all.size());
+    porId.reserve(all.size());
+    for (const auto& d : all)
+        onInsert(d.getId(), d);
+    valido = true;
+    revisao = rev;
+}
+
+void DisciplinaIndex::afterWrite(bool estavaEmDia, std::uint64_t rev)
+{
+    if (estavaEmDia)
+        revisao = rev;
+    else
+        valido = false;
+}
+
+int DisciplinaIndex::find(const std::string& matricula, int ano, int semestre) const
+{
+    auto it = porChave.find(Chave{matricula, ano, semestre});
+    return it == porChave.end() ? 0 : it->second;
+}
+
+void DisciplinaIndex::onInsert(int id, const Disciplina& d)
+{
+    Chave c = chaveDe(d);
+    // chave repetida: fica a primeira, as outras esperam em 'repetidas'
+    if (!porChave.emplace(c, id).second)
+        repetidas.emplace(c, id);
+    porId[id] = std::move(c);
+}
+
+void DisciplinaIndex::onUpdate(int id, const Disciplina& d)
+{
+    erase(id);
+    onInsert(id, d);
+}
+
+void DisciplinaIndex::onRemove(int id)
+{
+    erase(id);
+}
+
+void DisciplinaIndex::onRemoveSwapLast(int id, int lastId)
+{
+    erase(id);
+    if (id == lastId)
+        return;
+
+    auto it = porId.find(lastId);
+    if (it == porId.end())
+        return;
+    Chave c = std::move(it->second);
+    porId.erase(it);
+
+    auto ic = porChave.find(c);
+    if (ic != porChave.end() && ic->second == lastId) {
+        ic->second = id;
+    } else {
+        auto [ini, fim] = repetidas.equal_range(c);
+        for (auto ir = ini; ir != fim; ++ir) {
+            if (ir->second == lastId) {
+                ir->second = id;
+                break;
+            }
+        }
+    }
+    porId[id] = std::move(c);
+}
+
+void DisciplinaIndex::erase(int id)
+{
+    auto it = porId.find(id);
+    if (it == porId.end())
+        return;
+    const Chave& c = it->second;
+    auto [ini, fim] = repetidas.equal_range(c);
+    auto ic = porChave.find(c);
+    if (ic != porChave.end() && ic->second == id) {
+        // outro id ainda tem a chave: ele passa a ser o do índice
+        if (ini != fim) {
+            ic->second = ini->second;
+            repetidas.erase(ini);
+        } else {
+            porChave.erase(ic);
+        }
+    } else {
+        for (auto ir = ini; ir != fim; ++ir) {
+            if (ir->second == id) {
+                repetidas.erase(ir);
+                break;
+            }
+        }
+    }
+    porId.erase(it);
+}
@@ -0,0 +1,79 @@
+#include "DisciplinaQuery.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    double mediaOf(const Disciplina& d)
+    {
+        return (d.getNota1() + d.getNota2()) / 2.0;
+    }
+
+    std::string lower(std::string s)
+    {
+        std::transform(s.begin(), s.end(), s.begin(),
+                       [](unsigned char c){ return (char)std::tolower(c); });
+        return s;
+    }
+
+    // -1, 0, 1 comparando só o campo de ordenação
+    int compareField(const Disciplina& a, const Disciplina& b, DisciplinaSort field)
+    {
+        switch (field) {
+            case DisciplinaSort::Matricula: return a.getMatricula().compare(b.getMatricula());
+            case DisciplinaSort::Nome:      return a.getNome().compare(b.getNome());
+            case DisciplinaSort::Ano:       return (a.getAno() > b.getAno()) - (a.getAno() < b.getAno());
+            case DisciplinaSort::Semestre:  return (a.getSemestre() > b.getSemestre()) - (a.getSemestre() < b.getSemestre());
+            case DisciplinaSort::Creditos:  return (a.getCreditos() > b.getCreditos()) - (a.getCreditos() < b.getCreditos());
+            case DisciplinaSort::Media:     return (mediaOf(a) > mediaOf(b)) - (mediaOf(a) < mediaOf(b));
+            case DisciplinaSort::Id:        break;
+        }
+        return 0;
+    }
+}
+
+bool matchesQuery(const Disciplina& d, const DisciplinaQuery& q)
+{
+    if (!q.matricula.empty() && d.getMatricula() != q.matricula) return false;
+    if (q.ano      && d.getAno()      != *q.ano)      return false;
+    if (q.semestre && d.getSemestre() != *q.semestre) return false;
+    if (q.mediaMin || q.mediaMax) {
+        double m = mediaOf(d);
+        if (q.mediaMin && m < *q.mediaMin) return false;
+        if (q.mediaMax && m > *q.mediaMax) return false;
+    }
+    if (!q.nome.empty() && lower(d.getNome()).find(lower(q.nome)) == std::string::npos)
+        return false;
+    return true;
+}
+
+DisciplinaPage applyQuery(std::vector<Disciplina> all, const DisciplinaQuery& q)
+{
+    all.erase(std::remove_if(all.begin(), all.end(),
+                             [&](const Disciplina& d){ return !matchesQuery(d, q); }),
+              all.end());
+
+    DisciplinaPage page;
+    page.total = (int)all.size();
+
+    const size_t first = std::min(all.size(), (size_t)std::max(q.offset, 0));
+    const size_t last  = q.limit < 0 ? all.size()
+                                     : std::min(all.size(), first + (size_t)q.limit);
+    if (first == last)
+        return page;
+
+    auto less = [&](const Disciplina& a, const Disciplina& b){
+        int c = compareField(a, b, q.sort);
+        if (c == 0) c = (a.getId() > b.getId()) - (a.getId() < b.getId());
+        return q.desc ? c > 0 : c < 0;
+    };
+    // só é preciso ordenar até o fim da página pedida
+    if (last < all.size())
+        std::partial_sort(all.begin(), all.begin() + last, all.end(), less);
+    else
+        std::sort(all.begin(), all.end(), less);
+
+    page.items.assign(std::make_move_iterator(all.begin() + first),
+                      std::make_move_iterator(all.begin() + last));
+    return page;
+}
@@ -1,8 +1,12 @@
 #include "ConsoleLogger.hpp"
 #include <iostream>
+#include <mutex>
 
 namespace {
+    std::mutex mtx_log; // evita linhas misturadas quando há várias threads
+
     void write_log(std::ostream& os, const char* level, const std::string& message) {
+        std::lock_guard<std::mutex> lock(mtx_log);
         os << "[" << level << "] " << message << std::endl;
     }
 }
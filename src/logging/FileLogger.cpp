@@ -24,7 +24,7 @@ FileLogger::FileLogger(const Configuracao &conf)
 #if defined(_WIN32)
         localtime_s(&tm, &t);
 #else
-        localtime_r(&tm, &t);
+        localtime_r(&t, &tm);
 #endif
 
         std::ostringstream oss;
@@ -52,6 +52,7 @@ bool FileLogger::isOpen() const noexcept {
 }
 
 void FileLogger::write(const char* level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(mtx_);
     if (!file_.is_open()) {
         return;
     }
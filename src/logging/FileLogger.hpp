@@ -4,6 +4,7 @@
 
 #include "ILogger.hpp"
 #include <fstream>
+#include <mutex>
 #include <string>
 #include "Configuracao.hpp"
 
@@ -11,6 +12,7 @@ class FileLogger : public ILogger {
     private:
         bool verbose;
         std::ofstream file_;
+        std::mutex mtx_; // serializa escritas vindas de threads diferentes
 
         void write(const char* level, const std::string& message);
     public:
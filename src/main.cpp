@@ -13,6 +13,13 @@
 #include <iostream>
 #include <memory>
 
+#ifndef _WIN32
+  #include <csignal>
+  #include <cstdlib>
+  #include <pthread.h>
+  #include <thread>
+#endif
+
 #if defined(UI_IMPLEMENTATION_CONSOLE)
     #include "UIConsole.hpp"
     using UIType = UIConsole;
@@ -72,8 +79,51 @@
     #error "Nenhuma REPOSITORY_IMPLEMENTATION_* definida. Defina, por exemplo: -DREPOSITORY_IMPLEMENTATION=memory|bin|csv|fixed|json|sqlite|xml"
 #endif
 
+#ifndef _WIN32
+// Sinais de encerramento: ficam bloqueados em todas as threads (a máscara
+// é herdada, por isso é aplicada antes de criar qualquer uma) e uma thread
+// própria espera por eles com sigwait. Assim o que o repositório ainda tem
+// em buffer (ex.: BIN_FLUSH_BYTES) não se perde num kill/Ctrl+C. As UIs de
+// terminal tratam o Ctrl+C por conta própria.
+static sigset_t sinaisDeEncerramento()
+{
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGTERM);
+#if defined(UI_IMPLEMENTATION_WEB)
+    sigaddset(&set, SIGINT);
+#endif
+    return set;
+}
+
+static void encerrarNoSinal(IDisciplinaRepository& repo, ILogger& log)
+{
+    std::thread([&repo, &log] {
+        const sigset_t set = sinaisDeEncerramento();
+        int sig = 0;
+        if (sigwait(&set, &sig) != 0)
+            return;
+        LOG_INF("sinal ", sig, " recebido: gravando dados e encerrando");
+        try {
+            repo.flush();
+        }
+        catch (const std::exception& e) {
+            LOG_ERR("falha ao gravar dados no encerramento: ", e.what());
+        }
+        // as threads da UI continuam bloqueadas em accept/epoll: sai direto
+        std::_Exit(0);
+    }).detach();
+}
+#endif
+
 int main(int argc, char** argv)
 {
+#ifndef _WIN32
+    {
+        const sigset_t set = sinaisDeEncerramento();
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+    }
+#endif
     try {
         Configuracao config(argc, argv, "app.config");
         // 1. Configurar logger (ex: baseado em -v)
@@ -87,6 +137,9 @@ int main(int argc, char** argv)
         try {
             // 2. Escolher e criar o repositório ativo
             RepType repo(log, config);
+#ifndef _WIN32
+            encerrarNoSinal(repo, log);
+#endif
 
             // 3. Criar o service com o repositório
             HistoricoService historicoService(repo, log);
@@ -96,6 +149,9 @@ int main(int argc, char** argv)
 
             // 5. Deixar a UI assumir o controle
             ui.run();
+
+            // 6. Encerramento normal: nada do buffer fica para trás
+            repo.flush();
         }
         catch (const BusinessError& e) {
             LOG_ERR("erro infra nao tratado ", e.what())
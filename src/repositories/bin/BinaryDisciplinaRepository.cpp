@@ -1,9 +1,19 @@
 #include "BinaryDisciplinaRepository.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <fstream>
 #include <filesystem>
 #include <cstring>
 #include "Errors.hpp"
+#include "Uteis.hpp"
+
+#ifndef _WIN32
+  #include <cerrno>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -11,9 +21,79 @@ BinaryDisciplinaRepository::BinaryDisciplinaRepository(ILogger& aLog, const Conf
     : log(aLog), filename(conf.getFileName("bin"))
 {
     LOG_INF("BinaryDisciplinaRepository criado em arquivo: ", filename);
+
+    const std::string& modo = conf.getBinMsync();
+    if (modo == "SYNC")       msync = MappedFile::Sync::Sync;
+    else if (modo == "ASYNC") msync = MappedFile::Sync::Async;
+    else if (modo != "NONE") {
+        LOG_ERR("bin: BIN_MSYNC invalido (", modo, "), usando NONE");
+    }
+
+    // antes do mmap: a conversão troca o arquivo
+    migrarFormatoAntigo();
+
+    if (conf.getBinStorage() == "MMAP")
+    {
+        if (!MappedFile::supported()) {
+            LOG_INF("bin: mmap nao suportado nesta plataforma, usando streams");
+        }
+        else
+        {
+            // o arquivo fica aberto e mapeado até o destrutor
+            arquivo.open(filename);
+            LOG_INF("bin: arquivo mapeado em memoria, msync=", modo);
+        }
+    }
+    else if (conf.getBinStorage() != "STREAM") {
+        LOG_ERR("bin: BIN_STORAGE invalido (", conf.getBinStorage(), "), usando STREAM");
+    }
+
+    if (!mapeado())
+    {
+        flushBytes = static_cast<std::size_t>(conf.getBinFlushBytes());
+        flushIntervalo = std::chrono::milliseconds(conf.getBinFlushIntervalMs());
+        if (flushBytes > 0)
+        {
+            // o anel fica pronto antes do flusher, que já pode gravar
+            const bool comUring = uring.open();
+            LOG_INF("bin: buffer de escrita, bytes=", flushBytes, " intervalo_ms=", flushIntervalo.count(),
+                    comUring ? " io_uring" : " pwrite");
+        }
+        if (flushBytes > 0 && flushIntervalo.count() > 0)
+            flusher = std::thread(&BinaryDisciplinaRepository::flusherLoop, this);
+    }
+
+    try {
+        {
+            std::lock_guard<std::mutex> lock(arquivoMtx);
+            recuperarCabecalho();
+            observarArquivo();
+        }
+        indexar();
+    }
+    catch (const std::exception& e) {
+        // arquivo ilegível agora: exist() tenta de novo e propaga o erro
+        LOG_ERR("bin: falha ao indexar ", filename, ": ", e.what());
+    }
 }
 
-BinaryDisciplinaRepository::~BinaryDisciplinaRepository() = default;
+BinaryDisciplinaRepository::~BinaryDisciplinaRepository()
+{
+    {
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        parando = true;
+    }
+    flushCv.notify_all();
+    if (flusher.joinable())
+        flusher.join();
+
+    try {
+        flush();
+    }
+    catch (const std::exception& e) {
+        LOG_ERR("bin: falha ao gravar buffer de escrita no fechamento: ", e.what());
+    }
+}
 
 // --------------------------------------------------------
 // Helpers de string fixa
@@ -73,25 +153,541 @@ Disciplina BinaryDisciplinaRepository::fromRecord(const Record& r, int id)
 }
 
 // --------------------------------------------------------
-// Contagem de registros (sem cabeçalho, tamanho fixo)
+// CRC-32 (IEEE 802.3, o mesmo do zlib)
+// --------------------------------------------------------
+
+uint32_t BinaryDisciplinaRepository::crc32(const void* data, std::size_t len)
+{
+    static const std::array<uint32_t, 256> tabela = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    const auto* p = static_cast<const unsigned char*>(data);
+    uint32_t c = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < len; ++i)
+        c = tabela[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
 // --------------------------------------------------------
+// Bytes do arquivo (stream ou mmap)
+// --------------------------------------------------------
+
+std::size_t BinaryDisciplinaRepository::storageSize() const
+{
+    if (mapeado())
+    {
+        // fstat: enxerga gravações feitas por outro processo
+        arquivo.refresh();
+        return arquivo.size();
+    }
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filename, ec);
+    std::size_t total = ec ? 0 : static_cast<std::size_t>(size); // arquivo ainda não existe
+    if (!pendentes.empty())
+    {
+        const auto& ultimo = *pendentes.rbegin();
+        total = std::max(total, ultimo.first + ultimo.second.size());
+    }
+    return total;
+}
+
+void BinaryDisciplinaRepository::readAt(std::size_t offset, void* dest, std::size_t len) const
+{
+    if (mapeado())
+    {
+        if (offset + len > arquivo.size())
+            throw InfraError("Leitura alem do fim do arquivo binario de disciplinas.");
+        std::memcpy(dest, arquivo.data() + offset, len);
+        return;
+    }
+
+    char* out = static_cast<char*>(dest);
+    std::size_t doArquivo = len;
+    if (!pendentes.empty())
+    {
+        // só a parte que já está no arquivo; o resto vem do buffer
+        std::error_code ec;
+        auto size = std::filesystem::file_size(filename, ec);
+        const std::size_t noDisco = ec ? 0 : static_cast<std::size_t>(size);
+        doArquivo = offset < noDisco ? std::min(len, noDisco - offset) : 0;
+        std::memset(out + doArquivo, 0, len - doArquivo);
+    }
+
+    if (doArquivo > 0)
+    {
+        std::ifstream in(filename, ios::binary);
+        if (!in)
+            throw InfraError("Falha ao abrir arquivo binario de disciplinas para leitura.");
+        in.seekg(static_cast<std::streamoff>(offset), ios::beg);
+        in.read(out, static_cast<std::streamsize>(doArquivo));
+        if (!in)
+            throw InfraError("Falha ao ler arquivo binario de disciplinas.");
+    }
+
+    // trechos pendentes que cruzam [offset, offset + len)
+    auto it = pendentes.upper_bound(offset);
+    if (it != pendentes.begin())
+        --it;
+    for (; it != pendentes.end() && it->first < offset + len; ++it)
+    {
+        const std::size_t ini = std::max(offset, it->first);
+        const std::size_t fim = std::min(offset + len, it->first + it->second.size());
+        if (ini < fim)
+            std::memcpy(out + (ini - offset), it->second.data() + (ini - it->first), fim - ini);
+    }
+}
+
+void BinaryDisciplinaRepository::writeAt(std::size_t offset, const void* src, std::size_t len)
+{
+    gravacoes.fetch_add(1, std::memory_order_relaxed);
+    semFsync = true;
+
+    if (mapeado())
+    {
+        if (offset + len > arquivo.size())
+            arquivo.resize(offset + len);
+        std::memcpy(arquivo.data() + offset, src, len);
+        // no lote o msync fica para o commit (um só para o arquivo todo)
+        if (!emLote)
+            arquivo.sync(msync, offset, len);
+        anotarGravacaoPropria();
+        return;
+    }
+
+    if (bufferizado())
+    {
+        bufferizar(offset, src, len);
+        // no lote tudo espera o commit; fora dele, grava ao juntar flushBytes
+        if (!emLote && pendentesBytes >= flushBytes)
+            gravarPendentes(msync == MappedFile::Sync::Sync);
+        return;
+    }
+
+    // Garante existencia do arquivo
+    if (!std::filesystem::exists(filename))
+    {
+        std::ofstream create(filename, ios::binary);
+        if (!create)
+            throw InfraError("Nao foi possivel criar arquivo binario de disciplinas.");
+    }
+
+    std::fstream file(filename, ios::binary | ios::in | ios::out);
+    if (!file)
+        throw InfraError("Falha ao abrir arquivo binario de disciplinas para gravacao.");
+    file.seekp(static_cast<std::streamoff>(offset), ios::beg);
+    file.write(static_cast<const char*>(src), static_cast<std::streamsize>(len));
+    if (!file)
+        throw InfraError("Falha ao gravar no arquivo binario de disciplinas.");
+    file.close();
+    anotarGravacaoPropria();
+}
+
+// --------------------------------------------------------
+// Buffer de escrita
+// --------------------------------------------------------
+
+void BinaryDisciplinaRepository::bufferizar(std::size_t offset, const void* src, std::size_t len)
+{
+    if (pendentes.empty())
+        pendenteDesde = std::chrono::steady_clock::now();
+
+    // junta com os trechos que se sobrepõem ou encostam em [ini, fim)
+    std::size_t ini = offset;
+    std::size_t fim = offset + len;
+    auto primeiro = pendentes.upper_bound(offset);
+    if (primeiro != pendentes.begin())
+    {
+        auto ant = std::prev(primeiro);
+        if (ant->first + ant->second.size() >= offset)
+            primeiro = ant;
+    }
+    auto ultimo = primeiro;
+    while (ultimo != pendentes.end() && ultimo->first <= fim)
+    {
+        ini = std::min(ini, ultimo->first);
+        fim = std::max(fim, ultimo->first + ultimo->second.size());
+        ++ultimo;
+    }
+
+    std::vector<char> trecho(fim - ini);
+    for (auto it = primeiro; it != ultimo; ++it)
+    {
+        std::memcpy(trecho.data() + (it->first - ini), it->second.data(), it->second.size());
+        pendentesBytes -= it->second.size();
+    }
+    // o novo por cima dos antigos
+    std::memcpy(trecho.data() + (offset - ini), src, len);
+
+    pendentes.erase(primeiro, ultimo);
+    pendentesBytes += trecho.size();
+    pendentes.emplace(ini, std::move(trecho));
+}
+
+void BinaryDisciplinaRepository::gravarPendentes(bool duravel)
+{
+    if (mapeado())
+    {
+        if (duravel) {
+            arquivo.sync(MappedFile::Sync::Sync, 0, arquivo.size());
+            semFsync = false;
+        }
+        return;
+    }
+    if (pendentes.empty())
+        return;
+
+    // Slots antes do cabeçalho, como nas gravações diretas: o trecho que
+    // cobre o início do arquivo é partido e o cabeçalho vai por último,
+    // depois de um fsync dos slots quando a gravação é durável. Uma queda
+    // no meio deixa no máximo o cabeçalho atrasado (reconstruirCabecalho),
+    // nunca apontando para slots que não chegaram ao arquivo.
+    std::vector<UringWriter::Trecho> trechos;
+    trechos.reserve(pendentes.size() + 1);
+    UringWriter::Trecho cabecalho{0, nullptr, 0, true};
+    for (const auto& [offset, dados] : pendentes)
+    {
+        std::size_t ini = 0;
+        if (offset < sizeof(FileHeader))
+        {
+            ini = std::min(dados.size(), sizeof(FileHeader) - offset);
+            cabecalho = {offset, dados.data(), ini, true};
+        }
+        if (ini < dados.size())
+            trechos.push_back({offset + ini, dados.data() + ini, dados.size() - ini});
+    }
+    if (cabecalho.len > 0)
+        trechos.push_back(cabecalho);
+
+#ifdef _WIN32
+    if (!std::filesystem::exists(filename))
+        std::ofstream(filename, ios::binary);
+    std::fstream file(filename, ios::binary | ios::in | ios::out);
+    if (!file)
+        throw InfraError("Falha ao abrir arquivo binario de disciplinas para gravacao.");
+    for (const auto& t : trechos)
+    {
+        if (t.barreira)
+            file.flush();
+        file.seekp(static_cast<std::streamoff>(t.offset), ios::beg);
+        file.write(t.dados, static_cast<std::streamsize>(t.len));
+    }
+    file.flush();
+    if (!file)
+        throw InfraError("Falha ao gravar buffer no arquivo binario de disciplinas.");
+    (void)duravel; // sem fsync pelos streams
+#else
+    const int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw InfraError("Falha ao abrir arquivo binario de disciplinas para gravacao: "
+                         + std::string(std::strerror(errno)));
+    if (uring.isOpen())
+    {
+        // todos os trechos e os fsyncs numa só submissão, encadeados
+        try {
+            uring.write(fd, trechos, duravel);
+        }
+        catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+    else
+    {
+        // sem io_uring: um pwrite por trecho contíguo (inserções seguidas = um só)
+        const auto falha = [fd](const char* msg) {
+            const std::string err = std::strerror(errno);
+            ::close(fd);
+            return InfraError(msg + err);
+        };
+        for (const auto& t : trechos)
+        {
+            if (t.barreira && duravel && ::fsync(fd) != 0)
+                throw falha("Falha no fsync do arquivo binario de disciplinas: ");
+            std::size_t feito = 0;
+            while (feito < t.len)
+            {
+                const ssize_t n = ::pwrite(fd, t.dados + feito, t.len - feito,
+                                           static_cast<off_t>(t.offset + feito));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw falha("Falha ao gravar buffer no arquivo binario de disciplinas: ");
+                feito += static_cast<std::size_t>(n);
+            }
+        }
+        if (duravel && ::fsync(fd) != 0)
+            throw falha("Falha no fsync do arquivo binario de disciplinas: ");
+    }
+    ::close(fd);
+#endif
+
+    LOG_DBG("bin.flush trechos=", trechos.size(), " bytes=", pendentesBytes);
+    if (duravel)
+        semFsync = false;
+    pendentes.clear();
+    pendentesBytes = 0;
+    anotarGravacaoPropria();
+}
+
+void BinaryDisciplinaRepository::flusherLoop()
+{
+    std::unique_lock<std::mutex> lock(arquivoMtx);
+    while (!parando)
+    {
+        flushCv.wait_for(lock, flushIntervalo);
+        if (parando || emLote || pendentes.empty())
+            continue;
+        if (std::chrono::steady_clock::now() - pendenteDesde < flushIntervalo)
+            continue;
+        try {
+            gravarPendentes(msync == MappedFile::Sync::Sync);
+        }
+        catch (const std::exception& e) {
+            // fica no buffer: a próxima rodada (ou o flush explícito) tenta de novo
+            LOG_ERR("bin: falha ao gravar buffer de escrita: ", e.what());
+        }
+    }
+}
+
+void BinaryDisciplinaRepository::flush()
+{
+    std::lock_guard<std::mutex> lock(arquivoMtx);
+    gravarPendentes(true);
+    if (!semFsync)
+        return;
+
+    // buffer vazio, mas gravações anteriores sem fsync (BIN_MSYNC != SYNC)
+    const std::error_code ec = syncFile(filename);
+    if (ec)
+        throw InfraError("Falha no fsync do arquivo binario de disciplinas: " + ec.message());
+    semFsync = false;
+}
+
+// --------------------------------------------------------
+// Cabeçalho e slots
+// --------------------------------------------------------
+
+namespace {
+    const char MAGIC[4] = {'H', 'D', 'S', 'C'};
+}
+
+std::size_t BinaryDisciplinaRepository::slotOffset(int id)
+{
+    return sizeof(FileHeader) + static_cast<std::size_t>(id - 1) * sizeof(Slot);
+}
+
+BinaryDisciplinaRepository::FileHeader BinaryDisciplinaRepository::readHeader() const
+{
+    FileHeader h{};
+    const std::size_t size = storageSize();
+    if (size == 0)
+    {
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version  = FORMAT_VERSION;
+        h.slotSize = sizeof(Slot);
+        return h;
+    }
+
+    if (size < sizeof(FileHeader))
+        throw InfraError("Arquivo binario de disciplinas corrompido (cabecalho incompleto).");
+    readAt(0, &h, sizeof(h));
+
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw InfraError("Arquivo binario de disciplinas em formato desconhecido.");
+    if (h.checksum != crc32(&h, offsetof(FileHeader, checksum)))
+        throw InfraError("Arquivo binario de disciplinas corrompido (checksum do cabecalho).");
+    if (h.version != FORMAT_VERSION || h.slotSize != sizeof(Slot))
+        throw InfraError("Arquivo binario de disciplinas em versao nao suportada (versao="
+                         + to_string(h.version) + ").");
+    // maior é aceito: gravação interrompida entre o slot novo e o cabeçalho
+    if (size < slotOffset(h.slots + 1))
+        throw InfraError("Arquivo binario de disciplinas corrompido (tamanho inconsistente).");
+    return h;
+}
+
+void BinaryDisciplinaRepository::writeHeader(FileHeader& h)
+{
+    h.checksum = crc32(&h, offsetof(FileHeader, checksum));
+    writeAt(0, &h, sizeof(h));
+}
+
+void BinaryDisciplinaRepository::checkSlot(const Slot& s, int id)
+{
+    if (s.checksum != crc32(&s, offsetof(Slot, checksum)))
+        throw InfraError("Registro corrompido no arquivo binario de disciplinas (id=" + to_string(id) + ")");
+}
+
+BinaryDisciplinaRepository::Slot BinaryDisciplinaRepository::readLiveSlot(const FileHeader& h, int id) const
+{
+    if (id <= 0 || static_cast<uint32_t>(id) > h.slots)
+        throw InfraError("Disciplina nao encontrada (id=" + to_string(id) + ")");
 
-int BinaryDisciplinaRepository::getRecordCount() const
+    Slot s{};
+    readAt(slotOffset(id), &s, sizeof(s));
+    checkSlot(s, id);
+    if (s.state != SLOT_LIVE)
+        throw InfraError("Disciplina nao encontrada (id=" + to_string(id) + ")");
+    return s;
+}
+
+void BinaryDisciplinaRepository::writeSlot(int id, Slot& s)
 {
-    std::ifstream in(filename, ios::binary);
-    if (!in.good())
-        return 0; // arquivo ainda não existe
+    s.checksum = crc32(&s, offsetof(Slot, checksum));
+    writeAt(slotOffset(id), &s, sizeof(s));
+}
 
-    in.seekg(0, ios::end);
-    std::streampos size = in.tellg();
-    if (size < 0)
-        throw InfraError("Falha ao obter tamanho do arquivo binario de disciplinas.");
+void BinaryDisciplinaRepository::recuperarCabecalho()
+{
+    const std::size_t size = storageSize();
+    if (size <= sizeof(FileHeader))
+        return;
+
+    FileHeader h{};
+    readAt(0, &h, sizeof(h));
+    static const FileHeader zerado{};
+    if (std::memcmp(&h, &zerado, sizeof(h)) == 0)
+    {
+        // primeira inserção parou entre o slot e o cabeçalho: vale o que
+        // houver de slots íntegros no início
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version  = FORMAT_VERSION;
+        h.slotSize = sizeof(Slot);
+        for (int id = 1; slotOffset(id + 1) <= size; ++id)
+        {
+            Slot s{};
+            readAt(slotOffset(id), &s, sizeof(s));
+            if (s.checksum != crc32(&s, offsetof(Slot, checksum)))
+                break;
+            h.slots = static_cast<uint32_t>(id);
+        }
+        h.count = h.slots + 1;   // força a reconstrução abaixo
+    }
+    else
+    {
+        h = readHeader();
+    }
+
+    const auto antes = gravacoes.load(std::memory_order_relaxed);
+    reconstruirCabecalho(h);
+    if (gravacoes.load(std::memory_order_relaxed) != antes)
+        gravarPendentes(true);
+}
+
+BinaryDisciplinaRepository::FileHeader BinaryDisciplinaRepository::reconstruirCabecalho(FileHeader h)
+{
+    std::vector<Slot> slots(h.slots);
+    if (!slots.empty())
+        readAt(slotOffset(1), slots.data(), slots.size() * sizeof(Slot));
 
-    const auto recSize = static_cast<std::streamoff>(sizeof(Record));
-    if (size % recSize != 0)
+    uint32_t vivos = 0;
+    std::vector<uint32_t> livres;
+    for (std::size_t i = 0; i < slots.size(); ++i)
+    {
+        checkSlot(slots[i], static_cast<int>(i + 1));
+        if (slots[i].state == SLOT_LIVE)
+            vivos++;
+        else
+            livres.push_back(static_cast<uint32_t>(i + 1));
+    }
+
+    // a lista de livres confere se passa por todos os livres e só por eles
+    std::size_t naLista = 0;
+    bool listaOk = true;
+    for (uint32_t id = h.freeHead; id != 0 && listaOk; id = slots[id - 1].nextFree)
+    {
+        listaOk = id <= h.slots && slots[id - 1].state != SLOT_LIVE
+               && ++naLista <= livres.size();
+    }
+    if (listaOk && naLista == livres.size() && vivos == h.count)
+        return h;
+
+    LOG_ERR("bin: cabecalho nao confere com os slots (count=", h.count, " ocupados=", vivos,
+            " livres=", livres.size(), "), reconstruindo");
+
+    // slots antes do cabeçalho, como nas outras gravações
+    h.freeHead = 0;
+    for (const uint32_t id : livres)
+    {
+        Slot& s = slots[id - 1];
+        if (s.state != SLOT_FREE || s.nextFree != h.freeHead)
+        {
+            s.state    = SLOT_FREE;
+            s.nextFree = h.freeHead;
+            writeSlot(static_cast<int>(id), s);
+        }
+        h.freeHead = id;
+    }
+    h.count = vivos;
+    writeHeader(h);
+    return h;
+}
+
+void BinaryDisciplinaRepository::migrarFormatoAntigo()
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(filename, ec);
+    if (ec || size == 0)
+        return;
+
+    std::vector<char> dados(size);
+    {
+        std::ifstream in(filename, ios::binary);
+        if (!in || !in.read(dados.data(), static_cast<std::streamsize>(size)))
+            throw InfraError("Falha ao ler arquivo binario de disciplinas.");
+    }
+    if (size >= sizeof(MAGIC) && std::memcmp(dados.data(), MAGIC, sizeof(MAGIC)) == 0)
+        return;
+    // cabeçalho zerado: formato atual com a primeira inserção interrompida
+    // (recuperarCabecalho); no formato antigo a matrícula nunca é vazia
+    if (size > sizeof(FileHeader)
+        && std::all_of(dados.begin(), dados.begin() + sizeof(FileHeader), [](char c) { return c == 0; }))
+        return;
+
+    if (size % sizeof(Record) != 0)
         throw InfraError("Arquivo binario de disciplinas corrompido (tamanho inconsistente).");
 
-    return static_cast<int>(size / recSize);
+    // grava ao lado e troca: uma falha no meio não perde o arquivo antigo
+    const uint32_t total = static_cast<uint32_t>(size / sizeof(Record));
+    FileHeader h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version  = FORMAT_VERSION;
+    h.slotSize = sizeof(Slot);
+    h.slots    = total;
+    h.count    = total;
+    h.checksum = crc32(&h, offsetof(FileHeader, checksum));
+
+    const std::string tmp = filename + ".tmp";
+    {
+        std::ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (uint32_t i = 0; i < total; ++i)
+        {
+            Slot s{};
+            s.state = SLOT_LIVE;
+            std::memcpy(&s.rec, dados.data() + i * sizeof(Record), sizeof(Record));
+            s.checksum = crc32(&s, offsetof(Slot, checksum));
+            out.write(reinterpret_cast<const char*>(&s), sizeof(s));
+        }
+        out.close();
+        if (!out)
+            throw InfraError("Falha ao converter arquivo binario de disciplinas.");
+    }
+    // temporário no disco antes do rename e diretório depois: uma queda
+    // não pode trocar o arquivo antigo por um vazio ou pela metade
+    ec = durableReplace(tmp, filename);
+    if (ec)
+        throw InfraError("Falha ao substituir arquivo binario de disciplinas: " + ec.message());
+
+    LOG_INF("bin: arquivo convertido para o formato ", FORMAT_VERSION, ", registros=", total);
 }
 
 // --------------------------------------------------------
@@ -105,23 +701,13 @@ Disciplina BinaryDisciplinaRepository::get(int id) const
     if (id <= 0)
         throw InfraError("Id invalido para leitura de disciplina (id=" + to_string(id) + ")");
 
-    int total = getRecordCount();
-    if (id > total)
-        throw InfraError("Disciplina nao encontrada (id=" + to_string(id) + ")");
-
-    std::ifstream in(filename, ios::binary);
-    if (!in)
-        throw InfraError("Falha ao abrir arquivo binario de disciplinas para leitura.");
-
-    std::streamoff offset = static_cast<std::streamoff>(id - 1) * static_cast<std::streamoff>(sizeof(Record));
-    in.seekg(offset, ios::beg);
-
-    Record r{};
-    in.read(reinterpret_cast<char*>(&r), sizeof(r));
-    if (!in)
-        throw InfraError("Falha ao ler registro de disciplina (id=" + to_string(id) + ")");
+    Slot s{};
+    {
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        s = readLiveSlot(readHeader(), id);
+    }
 
-    Disciplina d = fromRecord(r, id);
+    Disciplina d = fromRecord(s.rec, id);
     LOG_DBG("bin.get ok id=", id, " nome=", d.getNome());
     return d;
 }
@@ -134,29 +720,50 @@ int BinaryDisciplinaRepository::insert(const Disciplina& disciplina)
 {
     LOG_DBG("bin.insert nome=", disciplina.getNome());
 
-    // Garante existencia do arquivo
+    const bool indexado = indice.isCurrent(revision());
+
+    Slot s{};
+    s.state = SLOT_LIVE;
+    s.rec   = toRecord(disciplina);
+
+    int newId = 0;
     {
-        std::fstream test(filename, ios::binary | ios::in | ios::out);
-        if (!test)
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        FileHeader h = readHeader();
+        Slot livre{};
+        if (h.freeHead != 0)
         {
-            std::ofstream create(filename, ios::binary);
-            if (!create)
-                throw InfraError("Nao foi possivel criar arquivo binario de disciplinas.");
+            readAt(slotOffset(static_cast<int>(h.freeHead)), &livre, sizeof(livre));
+            checkSlot(livre, static_cast<int>(h.freeHead));
+            if (livre.state != SLOT_FREE)
+            {
+                // cabeçalho de antes de uma gravação interrompida
+                h = reconstruirCabecalho(h);
+                if (h.freeHead != 0)
+                    readAt(slotOffset(static_cast<int>(h.freeHead)), &livre, sizeof(livre));
+            }
         }
-    }
-
-    int total = getRecordCount();
-    int newId = total + 1;
-
-    std::ofstream out(filename, ios::binary | ios::app);
-    if (!out)
-        throw InfraError("Falha ao abrir arquivo binario de disciplinas para append.");
+        if (h.freeHead != 0)
+        {
+            // reaproveita o slot livre mais recente
+            newId = static_cast<int>(h.freeHead);
+            h.freeHead = livre.nextFree;
+        }
+        else
+        {
+            newId = static_cast<int>(++h.slots);
+        }
+        h.count++;
 
-    Record r = toRecord(disciplina);
+        // Slot antes do cabeçalho. Se parar no meio: slot novo no fim fica
+        // só sem uso (fora de 'slots'); slot livre reaproveitado fica
+        // ocupado com o cabeçalho atrasado, que reconstruirCabecalho refaz.
+        writeSlot(newId, s);
+        writeHeader(h);
+    }
 
-    out.write(reinterpret_cast<const char*>(&r), sizeof(r));
-    if (!out)
-        throw InfraError("Falha ao gravar nova disciplina no arquivo binario.");
+    indice.onInsert(newId, fromRecord(s.rec, newId));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("bin.insert ok id=", newId);
     return newId;
@@ -170,22 +777,23 @@ void BinaryDisciplinaRepository::update(int id, const Disciplina& disciplina)
 {
     LOG_DBG("bin.update id=", id, " novo_nome=", disciplina.getNome());
 
-    int total = getRecordCount();
-    if (id <= 0 || id > total)
-        throw InfraError("Disciplina nao encontrada para atualizacao (id=" + to_string(id) + ")");
+    const bool indexado = indice.isCurrent(revision());
 
-    std::fstream file(filename, ios::binary | ios::in | ios::out);
-    if (!file)
-        throw InfraError("Falha ao abrir arquivo binario de disciplinas para atualizacao.");
-
-    Record r = toRecord(disciplina);
-    std::streamoff offset = static_cast<std::streamoff>(id - 1) * static_cast<std::streamoff>(sizeof(Record));
-
-    file.seekp(offset, ios::beg);
-    file.write(reinterpret_cast<const char*>(&r), sizeof(r));
+    Slot s{};
+    {
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        const FileHeader h = readHeader();
+        if (id <= 0 || static_cast<uint32_t>(id) > h.slots)
+            throw InfraError("Disciplina nao encontrada para atualizacao (id=" + to_string(id) + ")");
+        readLiveSlot(h, id);
+
+        s.state = SLOT_LIVE;
+        s.rec   = toRecord(disciplina);
+        writeSlot(id, s);
+    }
 
-    if (!file)
-        throw InfraError("Falha ao escrever disciplina atualizada no arquivo binario.");
+    indice.onUpdate(id, fromRecord(s.rec, id));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("bin.update ok id=", id);
 }
@@ -198,48 +806,35 @@ void BinaryDisciplinaRepository::remove(int id)
 {
     LOG_DBG("bin.remove id=", id);
 
-    int total = getRecordCount();
-    if (id <= 0 || id > total)
-        throw InfraError("Disciplina nao encontrada para remocao (id=" + to_string(id) + ")");
-
-    if (total == 0)
-        throw InfraError("Arquivo binario vazio na remocao (estado inconsistente).");
+    const bool indexado = indice.isCurrent(revision());
 
-    std::fstream file(filename, ios::binary | ios::in | ios::out);
-    if (!file)
-        throw InfraError("Falha ao abrir arquivo binario de disciplinas para remocao.");
-
-    const auto recSize = static_cast<std::streamoff>(sizeof(Record));
-    const int lastId = total;
-
-    if (id != lastId)
+    uint32_t restantes = 0;
     {
-        // Le ultimo registro
-        Record last{};
-        std::streamoff lastOffset = static_cast<std::streamoff>(lastId - 1) * recSize;
-        file.seekg(lastOffset, ios::beg);
-        file.read(reinterpret_cast<char*>(&last), sizeof(last));
-        if (!file)
-            throw InfraError("Falha ao ler ultimo registro durante remocao.");
-
-        // Sobrescreve o registro a remover com o ultimo
-        std::streamoff delOffset = static_cast<std::streamoff>(id - 1) * recSize;
-        file.seekp(delOffset, ios::beg);
-        file.write(reinterpret_cast<const char*>(&last), sizeof(last));
-        if (!file)
-            throw InfraError("Falha ao sobrescrever registro na remocao.");
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        FileHeader h = readHeader();
+        if (id <= 0 || static_cast<uint32_t>(id) > h.slots)
+            throw InfraError("Disciplina nao encontrada para remocao (id=" + to_string(id) + ")");
+        readLiveSlot(h, id);
+
+        // O(1): o slot entra no início da lista de livres; os outros ids
+        // não mudam
+        Slot livre{};
+        livre.state    = SLOT_FREE;
+        livre.nextFree = h.freeHead;
+        writeSlot(id, livre);
+
+        // se parar antes do cabeçalho, reconstruirCabecalho refaz count e
+        // a lista de livres ao abrir
+        h.freeHead = static_cast<uint32_t>(id);
+        h.count--;
+        writeHeader(h);
+        restantes = h.count;
     }
 
-    file.close();
-
-    // Trunca o arquivo removendo o ultimo bloco
-    std::error_code ec;
-    std::uintmax_t newSize = static_cast<std::uintmax_t>((total - 1) * sizeof(Record));
-    std::filesystem::resize_file(filename, newSize, ec);
-    if (ec)
-        throw InfraError("Falha ao truncar arquivo binario de disciplinas na remocao.");
+    indice.onRemove(id);
+    indice.afterWrite(indexado, revision());
 
-    LOG_DBG("bin.remove ok id=", id, " total_antigo=", total, " total_novo=", total - 1);
+    LOG_DBG("bin.remove ok id=", id, " restantes=", restantes);
 }
 
 // --------------------------------------------------------
@@ -250,34 +845,41 @@ bool BinaryDisciplinaRepository::exist(const std::string& matricula, int ano, in
 {
     LOG_DBG("bin.exist matricula=", matricula, " ano=", ano, " semestre=", semestre);
 
-    std::ifstream in(filename, ios::binary);
-    if (!in)
-        return false;
-
-    Record r{};
-    int id = 1;
-
-    while (in.read(reinterpret_cast<char*>(&r), sizeof(r)))
+    indexar();
+    int id = indice.find(matricula, ano, semestre);
+    if (id != 0)
     {
-        if (readStringFixed(r.matricula, sizeof(r.matricula)) == matricula &&
-            r.ano      == ano &&
-            r.semestre == semestre)
-        {
-            LOG_DBG("bin.exist true id=", id);
-            return true;
-        }
-        ++id;
+        LOG_DBG("bin.exist true id=", id);
+        return true;
     }
 
     LOG_DBG("bin.exist false");
     return false;
 }
 
+void BinaryDisciplinaRepository::indexar() const
+{
+    const std::uint64_t rev = revision();
+    if (indice.isCurrent(rev))
+        return;
+    indice.rebuild(list(), rev);
+    LOG_DBG("bin.indexar registros=", indice.size());
+}
+
 bool BinaryDisciplinaRepository::exist(int id) const
 {
     LOG_DBG("bin.exist(id) id=", id);
-    int total = getRecordCount();
-    bool ok = (id > 0 && id <= total);
+
+    std::lock_guard<std::mutex> lock(arquivoMtx);
+    const FileHeader h = readHeader();
+    bool ok = false;
+    if (id > 0 && static_cast<uint32_t>(id) <= h.slots)
+    {
+        Slot s{};
+        readAt(slotOffset(id), &s, sizeof(s));
+        checkSlot(s, id);
+        ok = s.state == SLOT_LIVE;
+    }
     LOG_DBG(ok ? "true" : "false");
     return ok;
 }
@@ -290,41 +892,99 @@ std::vector<Disciplina> BinaryDisciplinaRepository::list() const
 {
     LOG_DBG("bin.list");
 
-    std::vector<Disciplina> lst;
+    // só a cópia dos bytes fica sob o lock; CRC e conversão são feitos fora
+    std::vector<Slot> slots;
+    uint32_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        const FileHeader h = readHeader();
+        slots.resize(h.slots);
+        count = h.count;
+        if (!slots.empty())
+            readAt(slotOffset(1), slots.data(), slots.size() * sizeof(Slot));
+    }
 
-    std::ifstream in(filename, ios::binary);
-    if (!in)
+    std::vector<Disciplina> lst;
+    lst.reserve(count);
+    for (std::size_t i = 0; i < slots.size(); ++i)
     {
-        LOG_DBG("bin.list arquivo inexistente, retornando lista vazia");
-        return lst;
+        const int id = static_cast<int>(i + 1);
+        checkSlot(slots[i], id);
+        if (slots[i].state == SLOT_LIVE)
+            lst.push_back(fromRecord(slots[i].rec, id));
     }
 
-    // calcula total via tamanho do arquivo
-    in.seekg(0, ios::end);
-    std::streampos size = in.tellg();
-    if (size < 0)
-        throw InfraError("Falha ao obter tamanho do arquivo binario em list().");
+    // o estado de cada slot vale; o count do cabeçalho é só uma dica (pode
+    // estar atrasado por uma gravação interrompida, até a próxima abertura)
+    if (lst.size() != count) {
+        LOG_ERR("bin: count do cabecalho (", count, ") difere dos slots ocupados (", lst.size(), ")");
+    }
 
-    const auto recSize = static_cast<std::streamoff>(sizeof(Record));
-    if (size % recSize != 0)
-        throw InfraError("Arquivo binario de disciplinas corrompido em list().");
+    LOG_DBG("bin.list retornou=", lst.size());
+    return lst;
+}
 
-    int total = static_cast<int>(size / recSize);
-    lst.reserve(total);
+// --------------------------------------------------------
+// Lote
+// --------------------------------------------------------
 
-    in.seekg(0, ios::beg);
+void BinaryDisciplinaRepository::beginBatch()
+{
+    std::lock_guard<std::mutex> lock(arquivoMtx);
+    // o que está no buffer é de antes do lote: não pode sumir num rollback
+    gravarPendentes(false);
+    emLote = true;
+}
 
-    Record r{};
-    int id = 1;
-    while (id <= total && in.read(reinterpret_cast<char*>(&r), sizeof(r)))
+void BinaryDisciplinaRepository::commitBatch()
+{
+    std::lock_guard<std::mutex> lock(arquivoMtx);
+    // o lote inteiro numa gravação só
+    if (mapeado())
+        arquivo.sync(msync, 0, arquivo.size());
+    else
+        gravarPendentes(msync == MappedFile::Sync::Sync);
+    emLote = false;
+}
+
+void BinaryDisciplinaRepository::rollbackBatch()
+{
+    std::lock_guard<std::mutex> lock(arquivoMtx);
+    emLote = false;
+    if (pendentes.empty())
+        return;   // mmap/sem buffer: as gravações já estão no arquivo
+
+    // nada do lote chegou ao arquivo: basta descartar
+    pendentes.clear();
+    pendentesBytes = 0;
+    gravacoes.fetch_add(1, std::memory_order_relaxed);
+    indice.invalidate();
+}
+
+std::uint64_t BinaryDisciplinaRepository::observarArquivo() const
+{
+    const std::uint64_t rev = fileRevision(filename);
+    if (rev != revArquivo)
     {
-        lst.push_back(fromRecord(r, id));
-        ++id;
+        revArquivo = rev;
+        mudancasExternas++;
     }
+    return revArquivo;
+}
 
-    if ((id - 1) != total)
-        throw InfraError("Falha de leitura completa na listagem de disciplinas.");
+void BinaryDisciplinaRepository::anotarGravacaoPropria() const
+{
+    revArquivo = fileRevision(filename);
+}
 
-    LOG_DBG("bin.list retornou=", lst.size());
-    return lst;
+std::uint64_t BinaryDisciplinaRepository::revision() const
+{
+    std::uint64_t rev = 0;
+    {
+        std::lock_guard<std::mutex> lock(arquivoMtx);
+        observarArquivo();
+        rev = mudancasExternas * 1099511628211ull
+            ^ gravacoes.load(std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull;
+    }
+    return rev > 1 ? rev : 2;
 }
@@ -1,13 +1,22 @@
 #ifndef BINARY_DISCIPLINA_REPOSITORY_HPP
 #define BINARY_DISCIPLINA_REPOSITORY_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cstdint>
+#include <mutex>
 #include "ILogger.hpp"
 #include "IDisciplinaRepository.hpp"
 #include "Disciplina.hpp"
 #include "Configuracao.hpp"
+#include "DisciplinaIndex.hpp"
+#include "MappedFile.hpp"
+#include "UringWriter.hpp"
 
 class BinaryDisciplinaRepository : public IDisciplinaRepository
 {
@@ -27,10 +36,31 @@ public:
     // isto é a implementação natural para o modo binário.
     bool exist(int id) const;
 
+    // Modo MMAP: com BIN_MSYNC=SYNC o lote faz um único msync no commit.
+    // Modo STREAM com buffer: o lote fica todo no buffer e o commit grava
+    // tudo de uma vez; o rollback descarta o que não foi gravado.
+    void beginBatch() override;
+    void commitBatch() override;
+    void rollbackBatch() override;
+
+    // Muda a cada gravação deste repositório e quando o arquivo muda por
+    // fora (mtime + tamanho); os flushes do próprio buffer não contam.
+    std::uint64_t revision() const override;
+
+    // Grava o buffer de escrita e força o arquivo para o disco
+    // (fsync/msync MS_SYNC), inclusive o que já foi gravado sem fsync.
+    // Também chamado pelo destrutor.
+    void flush() override;
+
 private:
     ILogger& log;
     std::string filename;
 
+    // (matricula, ano, semestre) -> id: exist() sem varrer o arquivo
+    mutable DisciplinaIndex indice;
+    // Deixa 'indice' em dia com o arquivo (reconstrói se mudou por fora).
+    void indexar() const;
+
 #pragma pack(push, 1)
     struct Record
     {
@@ -42,8 +72,38 @@ private:
         double   nota1;
         double   nota2;
     };
+
+    // Formato do arquivo (FORMAT_VERSION 1):
+    //   FileHeader | Slot 1 | Slot 2 | ...
+    // O id é o número do slot e não muda com remoções: o slot removido
+    // entra na lista de livres (freeHead -> nextFree -> ...) e é o primeiro
+    // a ser reaproveitado. Cada slot tem o próprio CRC-32, conferido a cada
+    // leitura. Arquivos antigos (só Records) são convertidos ao abrir.
+    struct FileHeader
+    {
+        char     magic[4];      // "HDSC"
+        uint16_t version;
+        uint16_t slotSize;      // sizeof(Slot): detecta Record com outro layout
+        uint32_t slots;         // slots gravados (ocupados + livres)
+        uint32_t count;         // slots ocupados
+        uint32_t freeHead;      // primeiro slot livre (0 = nenhum)
+        uint32_t checksum;      // CRC-32 dos campos acima
+        char     reserved[8];
+    };
+
+    struct Slot
+    {
+        uint8_t  state;         // SLOT_FREE / SLOT_LIVE
+        uint32_t nextFree;      // só em slot livre
+        Record   rec;
+        uint32_t checksum;      // CRC-32 de state, nextFree e rec
+    };
 #pragma pack(pop)
 
+    static constexpr uint16_t FORMAT_VERSION = 1;
+    static constexpr uint8_t SLOT_FREE = 0;
+    static constexpr uint8_t SLOT_LIVE = 1;
+
     // Helpers
     static void writeStringFixed(char* dest, std::size_t maxLen, const std::string& src);
     static std::string readStringFixed(const char* src, std::size_t maxLen);
@@ -51,7 +111,80 @@ private:
     static Record toRecord(const Disciplina& d);
     static Disciplina fromRecord(const Record& r, int id);
 
-    int getRecordCount() const;
+    // Converte um arquivo sem cabeçalho (versão anterior) mantendo os ids.
+    void migrarFormatoAntigo();
+
+    // Cabeçalho e slots; chamar com arquivoMtx travado.
+    // readHeader de arquivo vazio devolve um cabeçalho sem slots.
+    FileHeader readHeader() const;
+    void writeHeader(FileHeader& h);
+    // InfraError se o id não é um slot ocupado ou o CRC não confere
+    Slot readLiveSlot(const FileHeader& h, int id) const;
+    void writeSlot(int id, Slot& s);
+    static void checkSlot(const Slot& s, int id);
+
+    // O slot é gravado antes do cabeçalho; uma parada entre os dois deixa
+    // count/freeHead atrasados. Cada slot se descreve (estado + CRC), então
+    // o cabeçalho é refeito a partir deles: ao abrir (recuperarCabecalho,
+    // que também cobre o cabeçalho zerado de um arquivo cuja primeira
+    // inserção parou no meio) e no insert que acha a lista de livres
+    // apontando para um slot ocupado. Chamar com arquivoMtx travado.
+    void recuperarCabecalho();
+    FileHeader reconstruirCabecalho(FileHeader h);
+
+    static uint32_t crc32(const void* data, std::size_t len);
+    static std::size_t slotOffset(int id);
+
+    // Bytes do arquivo, por stream ou mmap; chamar com arquivoMtx travado.
+    // writeAt além do fim aumenta o arquivo.
+    std::size_t storageSize() const;
+    void readAt(std::size_t offset, void* dest, std::size_t len) const;
+    void writeAt(std::size_t offset, const void* src, std::size_t len);
+
+    // Modo MMAP: o arquivo fica mapeado durante a vida do repositório.
+    // 'arquivoMtx' serializa o acesso ao arquivo (e ao mapeamento, que
+    // refresh() pode trocar).
+    mutable MappedFile arquivo;
+    mutable std::mutex arquivoMtx;
+    MappedFile::Sync msync = MappedFile::Sync::None;
+    bool emLote = false;
+    // há gravações no arquivo (ou no buffer) ainda sem fsync/msync MS_SYNC
+    bool semFsync = false;
+    // gravação no lugar pelo mapeamento nem sempre muda o mtime
+    std::atomic<std::uint64_t> gravacoes{0};
+
+    bool mapeado() const { return arquivo.isOpen(); }
+
+    // Buffer de escrita (modo STREAM com BIN_FLUSH_BYTES > 0): trechos
+    // pendentes por offset, sem sobreposição; trechos vizinhos são unidos,
+    // então inserções seguidas viram um único pwrite. readAt lê o arquivo
+    // e aplica os pendentes por cima. Supõe um único processo gravando.
+    // Com io_uring, todos os trechos (e o fsync) de um flush vão numa
+    // única submissão; sem ele, um pwrite por trecho.
+    std::map<std::size_t, std::vector<char>> pendentes;
+    UringWriter uring;
+    std::size_t pendentesBytes = 0;
+    std::size_t flushBytes = 0;
+    std::chrono::milliseconds flushIntervalo{0};
+    std::chrono::steady_clock::time_point pendenteDesde;
+    std::thread flusher;
+    std::condition_variable flushCv;
+    bool parando = false;
+
+    bool bufferizado() const { return flushBytes > 0 && !mapeado(); }
+    void bufferizar(std::size_t offset, const void* src, std::size_t len);
+    // chamar com arquivoMtx travado
+    void gravarPendentes(bool duravel);
+    void flusherLoop();
+
+    // revision(): mtime + tamanho visto por último e quantas vezes mudou
+    // por fora; chamar com arquivoMtx travado
+    mutable std::uint64_t revArquivo = 0;
+    mutable std::uint64_t mudancasExternas = 0;
+    std::uint64_t observarArquivo() const;
+    // Depois de uma gravação nossa: anota o mtime + tamanho novos sem
+    // contá-los como mudança externa.
+    void anotarGravacaoPropria() const;
 };
 
 #endif // BINARY_DISCIPLINA_REPOSITORY_HPP
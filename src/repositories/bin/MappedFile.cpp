@@ -0,0 +1,149 @@
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "Errors.hpp"
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+    std::string errnoText()
+    {
+        return std::strerror(errno);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::supported() { return false; }
+
+void MappedFile::open(const std::string&)
+{
+    throw InfraError("Arquivo mapeado em memoria nao suportado nesta plataforma.");
+}
+
+void MappedFile::close() {}
+bool MappedFile::refresh() { return false; }
+void MappedFile::resize(std::size_t) {}
+void MappedFile::sync(Sync, std::size_t, std::size_t) {}
+void MappedFile::remap(std::size_t) {}
+
+#else
+
+bool MappedFile::supported() { return true; }
+
+void MappedFile::open(const std::string& path)
+{
+    close();
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw InfraError("Falha ao abrir arquivo binario para mapeamento: " + errnoText());
+
+    try {
+        refresh();
+        if (!base)
+            remap(fileSize);
+    }
+    catch (...) {
+        close();
+        throw;
+    }
+}
+
+void MappedFile::close()
+{
+    if (base)
+        ::munmap(base, capacity);
+    base = nullptr;
+    capacity = 0;
+    fileSize = 0;
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+}
+
+bool MappedFile::refresh()
+{
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+        throw InfraError("Falha ao obter tamanho do arquivo binario: " + errnoText());
+
+    const std::size_t atual = static_cast<std::size_t>(st.st_size);
+    if (atual == fileSize)
+        return false;
+
+    fileSize = atual;
+    if (fileSize > capacity)
+        remap(fileSize);
+    return true;
+}
+
+void MappedFile::resize(std::size_t minSize)
+{
+    if (minSize <= fileSize)
+        return;
+
+    std::size_t novo = std::max(fileSize * 2, MIN_CAPACITY);
+    while (novo < minSize)
+        novo *= 2;
+
+#ifdef __APPLE__
+    // sem posix_fallocate: a falta de espaço só aparece ao gravar
+    int err = ::ftruncate(fd, static_cast<off_t>(novo)) == 0 ? 0 : errno;
+#else
+    int err = ::posix_fallocate(fd, 0, static_cast<off_t>(novo));
+    if (err == EOPNOTSUPP)
+        err = ::ftruncate(fd, static_cast<off_t>(novo)) == 0 ? 0 : errno;
+#endif
+    if (err != 0)
+        throw InfraError("Falha ao aumentar arquivo binario: " + std::string(std::strerror(err)));
+
+    fileSize = novo;
+    if (fileSize > capacity)
+        remap(fileSize);
+}
+
+void MappedFile::sync(Sync mode, std::size_t offset, std::size_t len)
+{
+    if (mode == Sync::None || len == 0)
+        return;
+
+    // msync exige endereço alinhado à página
+    static const std::size_t pagina = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t inicio = offset - offset % pagina;
+    const int flags = mode == Sync::Sync ? MS_SYNC : MS_ASYNC;
+    if (::msync(base + inicio, offset + len - inicio, flags) != 0)
+        throw InfraError("Falha no msync do arquivo binario: " + errnoText());
+}
+
+void MappedFile::remap(std::size_t minCapacity)
+{
+    std::size_t nova = capacity ? capacity : MIN_CAPACITY;
+    while (nova < minCapacity)
+        nova *= 2;
+
+    // mapear além do fim do arquivo é permitido; só não se pode tocar
+    // nessas páginas antes de o arquivo crescer até elas (resize)
+    void* p = ::mmap(nullptr, nova, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        throw InfraError("Falha ao mapear arquivo binario: " + errnoText());
+
+    if (base)
+        ::munmap(base, capacity);
+    base = static_cast<char*>(p);
+    capacity = nova;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Arquivo mapeado em memória (mmap, MAP_SHARED) para o repositório binário.
+//
+// - O arquivo é aberto e mapeado uma vez; leituras e gravações são memcpy
+//   direto no mapeamento, sem open/seek/read por operação.
+// - O arquivo cresce geometricamente: resize() reserva o dobro do tamanho
+//   atual com posix_fallocate (falta de espaço vira InfraError aqui, e não
+//   SIGBUS no memcpy), e o mapeamento acompanha. size() é o tamanho em disco,
+//   com o fim zerado; o tamanho lógico fica no cabeçalho de quem usa.
+// - refresh() relê o tamanho do arquivo (fstat) para enxergar gravações de
+//   outro processo; o conteúdo já é coerente pelo page cache.
+// - Só POSIX: em Windows isOpen() fica sempre false e o repositório usa os
+//   streams.
+// - Não é thread-safe: quem usa serializa o acesso.
+
+class MappedFile
+{
+public:
+    enum class Sync { None, Async, Sync };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    static bool supported();
+
+    // Cria o arquivo se não existir. InfraError em caso de falha.
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    std::size_t size() const { return fileSize; }
+    char* data() { return base; }
+    const char* data() const { return base; }
+
+    // true se o tamanho do arquivo mudou desde a última chamada
+    bool refresh();
+    // garante size() >= minSize; nunca diminui o arquivo
+    void resize(std::size_t minSize);
+
+    // msync de [offset, offset + len); None não faz nada
+    void sync(Sync mode, std::size_t offset, std::size_t len);
+
+private:
+    static constexpr std::size_t MIN_CAPACITY = 64 * 1024;
+
+    int fd = -1;
+    char* base = nullptr;
+    std::size_t capacity = 0;
+    std::size_t fileSize = 0;
+
+    void remap(std::size_t minCapacity);
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,248 @@
+#include "UringWriter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "Errors.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+  #define URING_WRITER_LINUX 1
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+UringWriter::~UringWriter()
+{
+    close();
+}
+
+#ifndef URING_WRITER_LINUX
+
+bool UringWriter::open() { return false; }
+void UringWriter::close() {}
+
+void UringWriter::write(int, const std::vector<Trecho>&, bool)
+{
+    throw InfraError("io_uring nao suportado nesta plataforma.");
+}
+
+std::size_t UringWriter::submeter(int, const std::vector<Trecho>&, const std::vector<std::size_t>&,
+                                  std::size_t, std::size_t fim, std::size_t&)
+{
+    return fim;
+}
+
+#else
+
+namespace {
+    std::string errnoText(int err)
+    {
+        return std::strerror(err);
+    }
+
+    void* mapear(int fd, std::size_t len, off_t offset)
+    {
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    // pwrite do que o io_uring não gravou (escrita curta)
+    void completar(int fd, const UringWriter::Trecho& t, std::size_t feito)
+    {
+        while (feito < t.len)
+        {
+            const ssize_t n = ::pwrite(fd, t.dados + feito, t.len - feito,
+                                       static_cast<off_t>(t.offset + feito));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                throw InfraError("Falha ao gravar trecho do arquivo binario: " + errnoText(errno));
+            feito += static_cast<std::size_t>(n);
+        }
+    }
+}
+
+bool UringWriter::open()
+{
+    close();
+
+    io_uring_params p{};
+    const long fd = ::syscall(__NR_io_uring_setup, ENTRADAS, &p);
+    if (fd < 0)
+        return false;
+    ringFd = static_cast<int>(fd);
+
+    sqMapLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqMapLen = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        sqMapLen = cqMapLen = std::max(sqMapLen, cqMapLen);
+
+    sqMap = mapear(ringFd, sqMapLen, IORING_OFF_SQ_RING);
+    if (sqMap && (p.features & IORING_FEAT_SINGLE_MMAP))
+        cqMap = sqMap;
+    else if (sqMap)
+        cqMap = mapear(ringFd, cqMapLen, IORING_OFF_CQ_RING);
+    sqesMapLen = p.sq_entries * sizeof(io_uring_sqe);
+    sqesMap = mapear(ringFd, sqesMapLen, IORING_OFF_SQES);
+    if (!sqMap || !cqMap || !sqesMap)
+    {
+        close();
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sqMap);
+    sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sqEntradas = p.sq_entries;
+
+    char* cq = static_cast<char*>(cqMap);
+    cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes = cq + p.cq_off.cqes;
+    return true;
+}
+
+void UringWriter::close()
+{
+    if (sqesMap)
+        ::munmap(sqesMap, sqesMapLen);
+    if (cqMap && cqMap != sqMap)
+        ::munmap(cqMap, cqMapLen);
+    if (sqMap)
+        ::munmap(sqMap, sqMapLen);
+    if (ringFd >= 0)
+        ::close(ringFd);
+    ringFd = -1;
+    sqMap = cqMap = sqesMap = nullptr;
+    sqMapLen = cqMapLen = sqesMapLen = 0;
+}
+
+void UringWriter::write(int fd, const std::vector<Trecho>& trechos, bool duravel)
+{
+    if (!isOpen())
+        throw InfraError("io_uring nao inicializado.");
+
+    std::vector<std::size_t> ops;
+    ops.reserve(trechos.size() + 2);
+    for (std::size_t i = 0; i < trechos.size(); ++i)
+    {
+        if (duravel && trechos[i].barreira && !ops.empty())
+            ops.push_back(FSYNC);
+        ops.push_back(i);
+    }
+    if (duravel)
+        ops.push_back(FSYNC);
+
+    // mais entradas que o anel comporta: em levas, uma depois da outra
+    std::size_t feito = 0;
+    std::size_t k = 0;
+    while (k < ops.size())
+    {
+        const std::size_t fim = std::min(ops.size(), k + sqEntradas);
+        k = submeter(fd, trechos, ops, k, fim, feito);
+        if (k < fim)
+            break;
+    }
+
+    // interrompida no meio: o resto em ordem, pelas chamadas comuns
+    for (; k < ops.size(); ++k, feito = 0)
+    {
+        if (ops[k] == FSYNC)
+        {
+            if (::fsync(fd) != 0)
+                throw InfraError("Falha no fsync do arquivo binario: " + errnoText(errno));
+        }
+        else
+        {
+            completar(fd, trechos[ops[k]], feito);
+        }
+    }
+}
+
+std::size_t UringWriter::submeter(int fd, const std::vector<Trecho>& trechos,
+                                  const std::vector<std::size_t>& ops,
+                                  std::size_t inicio, std::size_t fim, std::size_t& feito)
+{
+    auto* sqes = static_cast<io_uring_sqe*>(sqesMap);
+    unsigned tail = *sqTail;
+    for (std::size_t k = inicio; k < fim; ++k)
+    {
+        const unsigned idx = tail & sqMask;
+        io_uring_sqe& sqe = sqes[idx];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = fd;
+        if (ops[k] == FSYNC)
+        {
+            sqe.opcode = IORING_OP_FSYNC;
+        }
+        else
+        {
+            const Trecho& t = trechos[ops[k]];
+            sqe.opcode = IORING_OP_WRITE;
+            sqe.off = t.offset;
+            sqe.addr = reinterpret_cast<std::uintptr_t>(t.dados);
+            sqe.len = static_cast<unsigned>(t.len);
+        }
+        // a próxima só começa depois desta (e é cancelada se esta falhar)
+        if (k + 1 < fim)
+            sqe.flags = IOSQE_IO_LINK;
+        sqe.user_data = k;
+        sqArray[idx] = idx;
+        ++tail;
+    }
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+    const unsigned total = static_cast<unsigned>(fim - inicio);
+    std::vector<int> res(total, 0);
+    unsigned concluidos = 0;
+    while (concluidos < total)
+    {
+        const unsigned naoSubmetidos = tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        const long r = ::syscall(__NR_io_uring_enter, ringFd, naoSubmetidos,
+                                 total - concluidos, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (r < 0 && errno != EINTR)
+        {
+            // o anel pode ter ficado com entradas pendentes: descarta e
+            // deixa o chamador cair no pwrite
+            const int err = errno;
+            close();
+            throw InfraError("Falha no io_uring_enter: " + errnoText(err));
+        }
+
+        unsigned head = *cqHead;
+        const unsigned cqTailAtual = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != cqTailAtual; ++head, ++concluidos)
+        {
+            const io_uring_cqe& cqe = static_cast<io_uring_cqe*>(cqes)[head & cqMask];
+            res[static_cast<std::size_t>(cqe.user_data) - inicio] = cqe.res;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    // a cadeia termina na primeira que não foi até o fim; as seguintes
+    // vêm canceladas
+    for (std::size_t k = inicio; k < fim; ++k)
+    {
+        const int r = res[k - inicio];
+        const bool fsync = ops[k] == FSYNC;
+        const std::size_t esperado = fsync ? 0 : trechos[ops[k]].len;
+        if (r >= 0 && static_cast<std::size_t>(r) == esperado)
+            continue;
+        if (r < 0 && r != -ECANCELED && r != -EAGAIN && r != -EINTR)
+            throw InfraError(std::string(fsync ? "Falha no fsync do arquivo binario: "
+                                               : "Falha ao gravar trecho do arquivo binario: ")
+                             + errnoText(-r));
+        feito = r > 0 ? static_cast<std::size_t>(r) : 0;
+        return k;
+    }
+    return fim;
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef URING_WRITER_HPP
+#define URING_WRITER_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Gravação em lote por io_uring para o buffer de escrita do repositório
+// binário.
+//
+// - pwritev só aceita um offset, e os trechos pendentes de um flush são
+//   disjuntos (cabeçalho no início + slots). Aqui todos os trechos, e os
+//   fsyncs, vão numa única submissão (um io_uring_enter).
+// - As entradas são encadeadas (IOSQE_IO_LINK): cada uma só começa quando
+//   a anterior termina, na ordem dada. Se uma falha ou grava menos que o
+//   pedido, o kernel cancela as seguintes e o resto é feito em ordem por
+//   pwrite/fsync.
+// - O anel é criado uma vez (open) e reaproveitado em todos os flushes.
+// - open() devolve false quando o kernel não tem io_uring ou ele está
+//   bloqueado (seccomp, io_uring_disabled); quem usa cai no pwrite.
+// - Só Linux: nas outras plataformas open() devolve sempre false.
+// - Não é thread-safe: quem usa serializa o acesso.
+
+class UringWriter
+{
+public:
+    struct Trecho
+    {
+        std::size_t offset;
+        const char* dados;
+        std::size_t len;
+        bool barreira = false;  // duravel: fsync dos anteriores antes deste
+    };
+
+    UringWriter() = default;
+    ~UringWriter();
+
+    UringWriter(const UringWriter&) = delete;
+    UringWriter& operator=(const UringWriter&) = delete;
+
+    bool open();
+    void close();
+    bool isOpen() const { return ringFd >= 0; }
+
+    // Grava os trechos em fd, na ordem; se duravel, faz fsync antes de cada
+    // trecho com 'barreira' e no fim. InfraError em caso de falha.
+    void write(int fd, const std::vector<Trecho>& trechos, bool duravel);
+
+private:
+    static constexpr unsigned ENTRADAS = 64;
+
+    int ringFd = -1;
+    void* sqMap = nullptr;
+    std::size_t sqMapLen = 0;
+    void* cqMap = nullptr;
+    std::size_t cqMapLen = 0;
+    void* sqesMap = nullptr;
+    std::size_t sqesMapLen = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned sqEntradas = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    void* cqes = nullptr;
+
+    // Entrada do anel: índice do trecho, ou FSYNC.
+    static constexpr std::size_t FSYNC = static_cast<std::size_t>(-1);
+
+    // Submete ops[inicio, fim) encadeadas e espera todas as conclusões.
+    // Devolve a primeira que não terminou por inteiro (fim se todas) e,
+    // em 'feito', quanto dela já foi gravado.
+    std::size_t submeter(int fd, const std::vector<Trecho>& trechos,
+                         const std::vector<std::size_t>& ops,
+                         std::size_t inicio, std::size_t fim, std::size_t& feito);
+};
+
+#endif // URING_WRITER_HPP
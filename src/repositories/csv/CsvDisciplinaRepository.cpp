@@ -1,12 +1,19 @@
 #include "CsvDisciplinaRepository.hpp"
 
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <stdexcept>
 #include <iomanip>
+#include <condition_variable>
+#include <iterator>
+#include <thread>
 
+#include "CsvTokenizer.hpp"
 #include "Errors.hpp"
+#include "ThreadPool.hpp"
 #include "Uteis.hpp"
 
 using namespace std;
@@ -25,6 +32,29 @@ CsvDisciplinaRepository::CsvDisciplinaRepository(ILogger& aLog,
     filename = conf.getFileName("csv");
 
     LOG_INF("CsvDisciplinaRepository arquivo=", filename);
+
+    modoLog = conf.getCsvStorage() == "LOG";
+    compactPercent = conf.getCsvCompactPercent();
+    if (!modoLog && conf.getCsvStorage() != "REWRITE") {
+        LOG_ERR("csv: CSV_STORAGE invalido (", conf.getCsvStorage(), "), usando REWRITE");
+    }
+    if (modoLog) {
+        LOG_INF("csv: modo LOG, compactacao em ", compactPercent, "% de linhas mortas");
+    }
+
+    const int threads = conf.getCsvLoadThreads() > 0
+        ? conf.getCsvLoadThreads()
+        : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads > 1)
+        cargaThreads = static_cast<std::size_t>(threads);
+
+    try {
+        indexar();
+    }
+    catch (const std::exception& e) {
+        // arquivo ilegível agora: exist() tenta de novo e propaga o erro
+        LOG_ERR("csv: falha ao indexar ", filename, ": ", e.what());
+    }
 }
 
 CsvDisciplinaRepository::~CsvDisciplinaRepository() = default;
@@ -33,35 +63,15 @@ CsvDisciplinaRepository::~CsvDisciplinaRepository() = default;
 // Helpers CSV básicos (sem libs externas)
 // --------------------------------------------------------
 
-std::vector<std::string> CsvDisciplinaRepository::splitCsv(const std::string& line)
-{
-    std::vector<std::string> cols;
-    std::string current;
-
-    for (char c : line)
-    {
-        if (c == ',')
-        {
-            cols.push_back(trim(current));
-            current.clear();
-        }
-        else
-        {
-            current.push_back(c);
-        }
-    }
-
-    cols.push_back(trim(current));
-    return cols;
-}
-
 std::string CsvDisciplinaRepository::disciplinaToCsv(const Disciplina& d)
 {
     std::ostringstream oss;
 
-    // Não precisa escapar vírgula; assumido pelo domínio da aplicação.
-    oss << d.getMatricula() << ','
-        << d.getNome()      << ','
+    // entre aspas só quando precisa (ver CsvTokenizer.hpp)
+    writeCsvField(oss, d.getMatricula());
+    oss << ',';
+    writeCsvField(oss, d.getNome());
+    oss << ','
         << d.getSemestre()  << ','
         << d.getAno()       << ','
         << d.getCreditos()  << ',';
@@ -73,32 +83,50 @@ std::string CsvDisciplinaRepository::disciplinaToCsv(const Disciplina& d)
     return oss.str();
 }
 
-Disciplina CsvDisciplinaRepository::csvToDisciplina(const std::string& line, int id)
-{
-    auto cols = splitCsv(line);
-
-    if (cols.size() != 7)
-        throw ConversionError("Linha CSV invalida: quantidade de colunas diferente de 7.");
-
-    Disciplina d;
-    d.setId(id);
-    d.setMatricula(cols[0]);
-    d.setNome(cols[1]);
+// --------------------------------------------------------
+// Log de operações (modo LOG)
+// --------------------------------------------------------
 
-    try
+namespace {
+    // Mesmas regras de id da remoção com troca pelo último.
+    template <typename T>
+    void aplicarOperacao(std::vector<T>& v, char tipo, int id, T valor)
     {
-        d.setSemestre(std::stoi(cols[2]));
-        d.setAno(std::stoi(cols[3]));
-        d.setCreditos(std::stoi(cols[4]));
-        d.setNota1(std::stod(cols[5]));
-        d.setNota2(std::stod(cols[6]));
+        if (id <= 0 || id > static_cast<int>(v.size()))
+            throw ConversionError("Operacao invalida no log CSV (id=" + std::to_string(id) + ").");
+        if (tipo == 'U')
+        {
+            v[static_cast<size_t>(id - 1)] = std::move(valor);
+            return;
+        }
+        v[static_cast<size_t>(id - 1)] = std::move(v.back());
+        v.pop_back();
     }
-    catch (...)
+}
+
+bool CsvDisciplinaRepository::lerOperacao(const std::string& line, Operacao& op)
+{
+    if (line.size() < 4 || line[0] != '@' || line[2] != ',' || (line[1] != 'U' && line[1] != 'D'))
+        return false;
+
+    // registro tem 7 colunas; @U tem 9 e @D tem 2 (contadas pelo
+    // tokenizador: vírgula entre aspas não conta)
+    CsvField cols[2];
+    const int n = splitCsvFields(line, cols, 2);
+    if ((line[1] == 'U' && n != 9) || (line[1] == 'D' && n != 2))
+        return false;
+    if (!parseCsvInt(cols[1].text, op.id))
+        return false;
+
+    op.tipo = line[1];
+    op.registro.clear();
+    if (line[1] == 'U')
     {
-        throw ConversionError("Falha ao converter campos numericos do CSV de disciplina.");
+        // o id vem sem aspas (quem grava é o repositório)
+        const size_t fimId = line.find(',', 3);
+        op.registro = line.substr(fimId + 1);
     }
-
-    return d;
+    return true;
 }
 
 // --------------------------------------------------------
@@ -107,19 +135,65 @@ Disciplina CsvDisciplinaRepository::csvToDisciplina(const std::string& line, int
 
 int CsvDisciplinaRepository::getRecordCount() const
 {
-    std::ifstream in(filename);
-    if (!in.good())
-        return 0;
+    if (batch)
+        return static_cast<int>(batch->size());
 
-    int count = 0;
-    std::string line;
-    while (std::getline(in, line))
+    std::lock_guard<std::mutex> lock(offsetsMtx);
+    indexarOffsets();
+    return static_cast<int>(offsets.size());
+}
+
+void CsvDisciplinaRepository::indexarOffsets() const
+{
+    const std::uint64_t rev = revision();
+    if (rev == offsetsRev)
+        return;
+
+    offsets.clear();
+    tamanhoArquivo = 0;
+    terminaEmNovaLinha = true;
+    linhasMortas = 0;
+
+    // binário: as posições são as do arquivo (no Windows o modo texto
+    // esconderia o '\r')
+    std::ifstream in(filename, std::ios::binary);
+    if (in)
     {
-        if (!line.empty())
-            ++count;
+        std::string line;
+        std::streamoff pos = 0;
+        std::size_t naoVazias = 0;
+        Operacao op;
+        while (std::getline(in, line))
+        {
+            const std::streamoff inicio = pos;
+            terminaEmNovaLinha = !in.eof();
+            pos += static_cast<std::streamoff>(line.size()) + (terminaEmNovaLinha ? 1 : 0);
+
+            // mesma regra do getline dos outros leitores: linha vazia não é registro
+            if (line.empty())
+                continue;
+            ++naoVazias;
+
+            if (line.back() == '\r')
+                line.pop_back();
+            if (line[0] == '@' && lerOperacao(line, op))
+                aplicarOperacao(offsets, op.tipo, op.id, inicio);
+            else
+                offsets.push_back(inicio);
+        }
+        tamanhoArquivo = static_cast<std::uintmax_t>(pos);
+        linhasMortas = naoVazias - offsets.size();
     }
 
-    return count;
+    offsetsRev = rev;
+    LOG_DBG("csv.indexarOffsets registros=", offsets.size(), " mortas=", linhasMortas,
+            " bytes=", tamanhoArquivo);
+}
+
+void CsvDisciplinaRepository::invalidarOffsets()
+{
+    std::lock_guard<std::mutex> lock(offsetsMtx);
+    offsetsRev = 0;
 }
 
 bool CsvDisciplinaRepository::readLineById(int id, std::string& outLine) const
@@ -127,27 +201,182 @@ bool CsvDisciplinaRepository::readLineById(int id, std::string& outLine) const
     if (id <= 0)
         return false;
 
+    if (batch)
+    {
+        if (id > static_cast<int>(batch->size()))
+            return false;
+        outLine = (*batch)[static_cast<size_t>(id - 1)];
+        return true;
+    }
+
+    std::streamoff offset = 0;
+    {
+        std::lock_guard<std::mutex> lock(offsetsMtx);
+        indexarOffsets();
+        if (id > static_cast<int>(offsets.size()))
+            return false;
+        offset = offsets[static_cast<size_t>(id - 1)];
+    }
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return false;
+
+    in.seekg(offset);
+    if (!std::getline(in, outLine))
+        return false;
+    if (!outLine.empty() && outLine.back() == '\r')
+        outLine.pop_back();
+
+    // versão atual gravada pelo modo LOG
+    Operacao op;
+    if (!outLine.empty() && outLine[0] == '@' && lerOperacao(outLine, op))
+        outLine = op.registro;
+    return true;
+}
+
+std::streamoff CsvDisciplinaRepository::acrescentarLinha(const std::string& linha)
+{
+    const std::uintmax_t antes = tamanhoArquivo;
+    const bool separar = !terminaEmNovaLinha;
+
+    // Garantir que o arquivo exista (modo append já cria, mas se quiser tratar erro):
+    std::ofstream out(filename, std::ios::app);
+    if (!out)
+        throw InfraError("Falha ao abrir arquivo CSV para escrita.");
+
+    // última linha sem '\n': sem o separador a nova seria colada nela
+    if (separar)
+        out << '\n';
+    out << linha << '\n';
+    if (!out)
+        throw InfraError("Falha ao gravar disciplina no arquivo CSV.");
+    out.close();
+
+    // o tamanho do '\n' depende da plataforma (modo texto): sai da conta
+    std::error_code ec;
+    const std::uintmax_t depois = std::filesystem::file_size(filename, ec);
+    if (ec)
+    {
+        offsetsRev = 0;
+        throw InfraError("Falha ao obter tamanho do arquivo CSV: " + ec.message());
+    }
+    const std::uintmax_t nl = (depois - antes - linha.size()) / (separar ? 2 : 1);
+
+    tamanhoArquivo = depois;
+    terminaEmNovaLinha = true;
+    offsetsRev = revision();
+    return static_cast<std::streamoff>(antes + (separar ? nl : 0));
+}
+
+bool CsvDisciplinaRepository::readLines(std::vector<std::string>& lines) const
+{
     std::ifstream in(filename);
     if (!in)
         return false;
 
+    lines.reserve(128);
     std::string line;
-    int current = 0;
-
+    Operacao op;
     while (std::getline(in, line))
     {
         if (line.empty())
             continue;
+        if (line[0] == '@' && lerOperacao(line, op))
+            aplicarOperacao(lines, op.tipo, op.id, std::move(op.registro));
+        else
+            lines.push_back(line);
+    }
+    return true;
+}
 
-        ++current;
-        if (current == id)
-        {
-            outLine = line;
-            return true;
-        }
+void CsvDisciplinaRepository::writeLines(const std::vector<std::string>& lines) const
+{
+    const std::string tmp = filename + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out)
+            throw InfraError("Falha ao abrir arquivo CSV para escrita.");
+
+        for (const auto& l : lines)
+            out << l << '\n';
+
+        out.close();
+        if (!out)
+            throw InfraError("Falha ao gravar arquivo CSV.");
     }
 
-    return false;
+    // fsync do temporário antes do rename: sem ele uma queda pode deixar
+    // o CSV vazio ou pela metade
+    std::error_code ec = durableReplace(tmp, filename);
+    if (ec)
+    {
+        std::error_code ignorado;
+        std::filesystem::remove(tmp, ignorado);
+        throw InfraError("Falha ao substituir arquivo CSV: " + ec.message());
+    }
+}
+
+void CsvDisciplinaRepository::compact()
+{
+    LOG_DBG("csv.compact");
+    if (batch)
+        return;   // o commit do lote já regrava o arquivo
+
+    const bool indexado = indice.isCurrent(revision());
+    std::vector<std::string> lines;
+    if (!readLines(lines))
+        return;
+    writeLines(lines);
+    invalidarOffsets();
+    // os ids não mudam: o índice de chaves continua valendo
+    indice.afterWrite(indexado, revision());
+    LOG_INF("csv: arquivo compactado, registros=", lines.size());
+}
+
+void CsvDisciplinaRepository::compactarSePreciso()
+{
+    if (compactPercent <= 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(offsetsMtx);
+        const std::size_t limite = std::max(COMPACT_MIN_LINHAS,
+                                            offsets.size() * static_cast<std::size_t>(compactPercent) / 100);
+        if (linhasMortas < limite)
+            return;
+    }
+    compact();
+}
+
+// --------------------------------------------------------
+// Lote
+// --------------------------------------------------------
+
+void CsvDisciplinaRepository::beginBatch()
+{
+    LOG_DBG("csv.beginBatch");
+    auto lines = std::make_unique<std::vector<std::string>>();
+    readLines(*lines); // arquivo inexistente = lote sobre lista vazia
+    batch = std::move(lines);
+}
+
+void CsvDisciplinaRepository::commitBatch()
+{
+    if (!batch)
+        return;
+    const bool indexado = indice.isCurrent(revision());
+    std::unique_ptr<std::vector<std::string>> lines = std::move(batch);
+    writeLines(*lines);
+    invalidarOffsets();
+    indice.afterWrite(indexado, revision());
+    LOG_DBG("csv.commitBatch linhas=", lines->size());
+}
+
+void CsvDisciplinaRepository::rollbackBatch()
+{
+    LOG_DBG("csv.rollbackBatch");
+    batch.reset();
+    indice.invalidate();   // tinha as operações descartadas
 }
 
 // --------------------------------------------------------
@@ -175,20 +404,28 @@ int CsvDisciplinaRepository::insert(const Disciplina& disciplina)
 {
     LOG_DBG("csv.insert nome=", disciplina.getNome());
 
-    // Garantir que o arquivo exista (modo append já cria, mas se quiser tratar erro):
-    std::ofstream out(filename, std::ios::app);
-    if (!out)
-        throw InfraError("Falha ao abrir arquivo CSV para escrita.");
-
+    const bool indexado = indice.isCurrent(revision());
     std::string line = disciplinaToCsv(disciplina);
 
-    // Se arquivo não está vazio e não termina com newline, std::ofstream em texto já cuida,
-    // mas vamos sempre adicionar newline explícito.
-    out << line << '\n';
-    if (!out)
-        throw InfraError("Falha ao gravar disciplina no arquivo CSV.");
+    if (batch)
+    {
+        batch->push_back(line);
+        const int newId = static_cast<int>(batch->size());
+        indice.onInsert(newId, csvToDisciplina(line, newId));
+        LOG_DBG("csv.insert (lote) id=", newId);
+        return newId;
+    }
 
-    int total = getRecordCount();
+    int total = 0;
+    {
+        std::lock_guard<std::mutex> lock(offsetsMtx);
+        indexarOffsets();
+        offsets.push_back(acrescentarLinha(line));
+        total = static_cast<int>(offsets.size());
+    }
+
+    indice.onInsert(total, csvToDisciplina(line, total));
+    indice.afterWrite(indexado, revision());
     LOG_DBG("csv.insert ok id=", total);
     return total; // novo id é ultima linha
 }
@@ -200,36 +437,47 @@ void CsvDisciplinaRepository::update(int id, const Disciplina& disciplina)
     if (id <= 0)
         throw InfraError("Id invalido para atualizacao (id=" + std::to_string(id) + ")");
 
-    std::ifstream in(filename);
-    if (!in)
-        throw InfraError("Falha ao abrir arquivo CSV para leitura em update.");
+    const bool indexado = indice.isCurrent(revision());
 
-    std::vector<std::string> lines;
-    lines.reserve(128);
-
-    std::string line;
-    while (std::getline(in, line))
+    if (modoLog && !batch)
     {
-        if (!line.empty())
-            lines.push_back(line);
+        // O(registro): acrescenta a nova versão
+        const std::string registro = disciplinaToCsv(disciplina);
+        {
+            std::lock_guard<std::mutex> lock(offsetsMtx);
+            indexarOffsets();
+            if (id > static_cast<int>(offsets.size()))
+                throw InfraError("Disciplina nao encontrada para atualizacao (id=" + std::to_string(id) + ")");
+            offsets[static_cast<size_t>(id - 1)] =
+                acrescentarLinha("@U," + std::to_string(id) + "," + registro);
+            linhasMortas++;
+        }
+        indice.onUpdate(id, csvToDisciplina(registro, id));
+        indice.afterWrite(indexado, revision());
+        compactarSePreciso();
+        LOG_DBG("csv.update ok (log) id=", id);
+        return;
     }
 
+    std::vector<std::string> local;
+    std::vector<std::string>& lines = batch ? *batch : local;
+    if (!batch && !readLines(lines))
+        throw InfraError("Falha ao abrir arquivo CSV para leitura em update.");
+
     if (id > static_cast<int>(lines.size()))
         throw InfraError("Disciplina nao encontrada para atualizacao (id=" + std::to_string(id) + ")");
 
     // Substitui linha correspondente
     lines[static_cast<size_t>(id - 1)] = disciplinaToCsv(disciplina);
 
-    // Regrava arquivo completo
-    std::ofstream out(filename, std::ios::trunc);
-    if (!out)
-        throw InfraError("Falha ao abrir arquivo CSV para escrita em update.");
-
-    for (const auto& l : lines)
-        out << l << '\n';
-
-    if (!out)
-        throw InfraError("Falha ao gravar arquivo CSV em update.");
+    // Regrava arquivo completo (no lote, só no commit)
+    if (!batch)
+    {
+        writeLines(lines);
+        invalidarOffsets();
+    }
+    indice.onUpdate(id, csvToDisciplina(lines[static_cast<size_t>(id - 1)], id));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("csv.update ok id=", id);
 }
@@ -241,20 +489,34 @@ void CsvDisciplinaRepository::remove(int id)
     if (id <= 0)
         throw InfraError("Id invalido para remocao (id=" + std::to_string(id) + ")");
 
-    std::ifstream in(filename);
-    if (!in)
-        throw InfraError("Falha ao abrir arquivo CSV para leitura em remove.");
+    const bool indexado = indice.isCurrent(revision());
 
-    std::vector<std::string> lines;
-    lines.reserve(128);
-
-    std::string line;
-    while (std::getline(in, line))
+    if (modoLog && !batch)
     {
-        if (!line.empty())
-            lines.push_back(line);
+        // O(registro): acrescenta a remoção
+        int total = 0;
+        {
+            std::lock_guard<std::mutex> lock(offsetsMtx);
+            indexarOffsets();
+            total = static_cast<int>(offsets.size());
+            if (id > total)
+                throw InfraError("Disciplina nao encontrada para remocao (id=" + std::to_string(id) + ")");
+            acrescentarLinha("@D," + std::to_string(id));
+            aplicarOperacao(offsets, 'D', id, std::streamoff(0));
+            linhasMortas += 2;   // a linha @D e a versão removida
+        }
+        indice.onRemoveSwapLast(id, total);
+        indice.afterWrite(indexado, revision());
+        compactarSePreciso();
+        LOG_DBG("csv.remove ok (log) id=", id, " total_antigo=", total, " total_novo=", total - 1);
+        return;
     }
 
+    std::vector<std::string> local;
+    std::vector<std::string>& lines = batch ? *batch : local;
+    if (!batch && !readLines(lines))
+        throw InfraError("Falha ao abrir arquivo CSV para leitura em remove.");
+
     int total = static_cast<int>(lines.size());
     if (id > total || total == 0)
         throw InfraError("Disciplina nao encontrada para remocao (id=" + std::to_string(id) + ")");
@@ -267,15 +529,13 @@ void CsvDisciplinaRepository::remove(int id)
 
     lines.pop_back();
 
-    std::ofstream out(filename, std::ios::trunc);
-    if (!out)
-        throw InfraError("Falha ao abrir arquivo CSV para escrita em remove.");
-
-    for (const auto& l : lines)
-        out << l << '\n';
-
-    if (!out)
-        throw InfraError("Falha ao gravar arquivo CSV em remove.");
+    if (!batch)
+    {
+        writeLines(lines);
+        invalidarOffsets();
+    }
+    indice.onRemoveSwapLast(id, total);
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("csv.remove ok id=", id, " total_antigo=", total, " total_novo=", total - 1);
 }
@@ -285,26 +545,181 @@ std::vector<Disciplina> CsvDisciplinaRepository::list() const
     LOG_DBG("csv.list");
 
     std::vector<Disciplina> out;
-    std::ifstream in(filename);
+
+    if (batch)
+    {
+        int id = 0;
+        for (const auto& line : *batch)
+            out.push_back(csvToDisciplina(line, ++id));
+        return out;
+    }
+
+    std::ifstream in(filename, std::ios::binary);
     if (!in)
     {
         LOG_DBG("csv.list arquivo inexistente, retornando vazio");
         return out;
     }
 
-    std::string line;
-    int id = 0;
+    in.seekg(0, std::ios::end);
+    const std::streamoff tamanho = in.tellg();
+    in.seekg(0);
+    std::string conteudo(static_cast<size_t>(std::max<std::streamoff>(tamanho, 0)), '\0');
+    if (tamanho < 0 || !in.read(conteudo.data(), tamanho))
+        throw InfraError("Falha ao ler arquivo CSV.");
+    in.close();
 
-    while (std::getline(in, line))
+    out = carregar(conteudo);
+
+    LOG_DBG("csv.list retornou=", out.size());
+    return out;
+}
+
+// --------------------------------------------------------
+// Carga paralela (list)
+// --------------------------------------------------------
+
+void CsvDisciplinaRepository::carregarPedaco(PedacoCarga& p)
+{
+    try
     {
-        if (line.empty())
-            continue;
+        std::string_view resto = p.texto;
+        Operacao op;
+        while (!resto.empty())
+        {
+            const size_t nl = resto.find('\n');
+            std::string_view linha = resto.substr(0, nl);
+            resto.remove_prefix(nl == std::string_view::npos ? resto.size() : nl + 1);
+            ++p.linhas;
+
+            // mesmas regras do readLines: linha vazia não é registro
+            if (linha.empty())
+                continue;
+            if (linha.back() == '\r')
+                linha.remove_suffix(1);
+
+            if (!linha.empty() && linha[0] == '@' && lerOperacao(std::string(linha), op))
+            {
+                OperacaoCarga o;
+                o.antes = p.registros.size();
+                o.linha = p.linhas;
+                o.tipo = op.tipo;
+                o.id = op.id;
+                if (op.tipo == 'U')
+                    o.registro = csvToDisciplina(op.registro, 0);
+                p.operacoes.push_back(std::move(o));
+            }
+            else
+            {
+                p.registros.push_back(csvToDisciplina(linha, 0));
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        p.linhaErro = p.linhas;
+        p.erro = e.what();
+    }
+}
+
+ThreadPool& CsvDisciplinaRepository::poolCarga() const
+{
+    std::lock_guard<std::mutex> lock(cargaPoolMtx);
+    if (!cargaPool)
+    {
+        cargaPool = std::make_unique<ThreadPool>(cargaThreads);
+        LOG_INF("csv: carga paralela com ", cargaThreads, " threads");
+    }
+    return *cargaPool;
+}
 
-        ++id;
-        out.push_back(csvToDisciplina(line, id));
+std::vector<Disciplina> CsvDisciplinaRepository::carregar(std::string_view conteudo) const
+{
+    ThreadPool* pool = nullptr;
+    size_t n = 1;
+    if (cargaThreads > 1 && conteudo.size() >= CARGA_PARALELA_MIN_BYTES)
+    {
+        pool = &poolCarga();
+        n = pool->size();
     }
 
-    LOG_DBG("csv.list retornou=", out.size());
+    // cortes em tamanhos iguais, empurrados até depois do próximo '\n'
+    std::vector<PedacoCarga> pedacos(n);
+    size_t inicio = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t fim = conteudo.size();
+        if (i + 1 < n)
+        {
+            fim = std::max(inicio, conteudo.size() / n * (i + 1));
+            fim = conteudo.find('\n', fim);
+            fim = fim == std::string_view::npos ? conteudo.size() : fim + 1;
+        }
+        pedacos[i].texto = conteudo.substr(inicio, fim - inicio);
+        inicio = fim;
+    }
+
+    if (n == 1)
+    {
+        carregarPedaco(pedacos[0]);
+    }
+    else
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t faltam = n;
+        for (auto& p : pedacos)
+        {
+            pool->submit([&, pp = &p] {
+                carregarPedaco(*pp);
+                std::lock_guard<std::mutex> lock(mtx);
+                if (--faltam == 0)
+                    cv.notify_one();
+            });
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&] { return faltam == 0; });
+    }
+
+    const auto naLinha = [](const std::string& erro, size_t linha) {
+        return ConversionError(erro + " (linha " + std::to_string(linha) + " do CSV)");
+    };
+
+    size_t total = 0;
+    for (const auto& p : pedacos)
+        total += p.registros.size();
+
+    std::vector<Disciplina> out;
+    out.reserve(total);
+    size_t linhaBase = 0;
+    for (auto& p : pedacos)
+    {
+        if (p.linhaErro != 0)
+            throw naLinha(p.erro, linhaBase + p.linhaErro);
+
+        auto proximo = p.registros.begin();
+        for (auto& o : p.operacoes)
+        {
+            const auto ate = p.registros.begin() + static_cast<std::ptrdiff_t>(o.antes);
+            out.insert(out.end(), std::make_move_iterator(proximo), std::make_move_iterator(ate));
+            proximo = ate;
+            try
+            {
+                aplicarOperacao(out, o.tipo, o.id, std::move(o.registro));
+            }
+            catch (const ConversionError& e)
+            {
+                throw naLinha(e.what(), linhaBase + o.linha);
+            }
+        }
+        out.insert(out.end(), std::make_move_iterator(proximo),
+                   std::make_move_iterator(p.registros.end()));
+        linhaBase += p.linhas;
+    }
+
+    // ids são posições: só se conhecem depois da junção
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i].setId(static_cast<int>(i + 1));
     return out;
 }
 
@@ -315,33 +730,28 @@ bool CsvDisciplinaRepository::exist(const std::string& matricula,
     LOG_DBG("csv.exist matricula=", matricula,
             " ano=", ano, " semestre=", semestre);
 
-    std::ifstream in(filename);
-    if (!in)
-        return false;
-
-    std::string line;
-    int id = 0;
-
-    while (std::getline(in, line))
+    indexar();
+    int id = indice.find(matricula, ano, semestre);
+    if (id != 0)
     {
-        if (line.empty())
-            continue;
-
-        ++id;
-        auto d = csvToDisciplina(line, id);
-        if (d.getMatricula() == matricula &&
-            d.getAno()       == ano &&
-            d.getSemestre()  == semestre)
-        {
-            LOG_DBG("csv.exist true id=", id);
-            return true;
-        }
+        LOG_DBG("csv.exist true id=", id);
+        return true;
     }
 
     LOG_DBG("csv.exist false");
     return false;
 }
 
+void CsvDisciplinaRepository::indexar() const
+{
+    // no lote, revision() é a do arquivo e list() já traz as linhas do lote
+    const std::uint64_t rev = revision();
+    if (indice.isCurrent(rev))
+        return;
+    indice.rebuild(list(), rev);
+    LOG_DBG("csv.indexar registros=", indice.size());
+}
+
 bool CsvDisciplinaRepository::exist(int id) const
 {
     LOG_DBG("csv.exist(id) id=", id);
@@ -350,3 +760,8 @@ bool CsvDisciplinaRepository::exist(int id) const
     LOG_DBG(ok ? "true" : "false");
     return ok;
 }
+
+std::uint64_t CsvDisciplinaRepository::revision() const
+{
+    return fileRevision(filename);
+}
@@ -1,13 +1,21 @@
 #ifndef CSV_DISCIPLINA_REPOSITORY_HPP
 #define CSV_DISCIPLINA_REPOSITORY_HPP
 
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "ILogger.hpp"
 #include "IDisciplinaRepository.hpp"
 #include "Disciplina.hpp"
 #include "Configuracao.hpp"
+#include "DisciplinaIndex.hpp"
+
+class ThreadPool;
 
 class CsvDisciplinaRepository : public IDisciplinaRepository
 {
@@ -24,17 +32,117 @@ public:
 
     bool exist(int id) const; // se tiver no contrato, essa é a implementação natural
 
+    // mtime + tamanho do arquivo: detecta também gravações de fora
+    std::uint64_t revision() const override;
+
+    void beginBatch() override;
+    void commitBatch() override;
+    void rollbackBatch() override;
+
+    // Regrava só os registros vivos (modo LOG), via temporário + rename.
+    void compact();
+
 private:
     ILogger& log;
     std::string filename;
 
+    // linhas do lote em andamento (nullptr fora de lote): as operações
+    // alteram só a memória e commitBatch regrava o arquivo uma vez
+    std::unique_ptr<std::vector<std::string>> batch;
+
+    // (matricula, ano, semestre) -> id: exist() sem varrer o arquivo
+    mutable DisciplinaIndex indice;
+    // Deixa 'indice' em dia com o arquivo (reconstrói se mudou por fora).
+    void indexar() const;
+
+    // Modo LOG (CSV_STORAGE=LOG): update e remove acrescentam uma linha
+    // de operação, O(registro), em vez de regravar o arquivo:
+    //   @U,<id>,<registro>   o registro id passa a ser <registro>
+    //   @D,<id>              remove o id (o último passa a ocupar o id)
+    // Quem lê aplica as operações na ordem (em qualquer modo, então um
+    // arquivo com log continua legível em REWRITE). Um registro tem sempre
+    // 7 colunas, o que separa as operações de uma matrícula começando com
+    // '@'.
+    struct Operacao
+    {
+        char tipo = 0;          // 'U' ou 'D'
+        int id = 0;
+        std::string registro;   // só no 'U'
+    };
+    static bool lerOperacao(const std::string& line, Operacao& op);
+
+    bool modoLog = false;
+    int compactPercent = 50;
+    // compacta só a partir deste número de linhas mortas
+    static constexpr std::size_t COMPACT_MIN_LINHAS = 64;
+    void compactarSePreciso();
+
+    // Registros vivos, já com o log aplicado. Retorna false se não
+    // conseguiu abrir.
+    bool readLines(std::vector<std::string>& lines) const;
+    // Temporário + rename: uma falha no meio não corrompe o arquivo.
+    void writeLines(const std::vector<std::string>& lines) const;
+
     int  getRecordCount() const;
     bool readLineById(int id, std::string& line) const;
 
-    static std::string disciplinaToCsv(const Disciplina& d);
-    static Disciplina csvToDisciplina(const std::string& line, int id);
+    // Offset (em bytes) da versão atual de cada registro (no modo LOG pode
+    // ser uma linha @U): readLineById faz um seek direto e getRecordCount
+    // é offsets.size(). Montado numa passada pelo arquivo, carimbado com a
+    // revision() e reconstruído só quando o arquivo muda por fora; os
+    // appends do próprio repositório só o ajustam.
+    // Tem mutex próprio: get() roda em paralelo com outras leituras.
+    mutable std::mutex offsetsMtx;
+    mutable std::vector<std::streamoff> offsets;
+    mutable std::uint64_t offsetsRev = 0;
+    mutable std::uintmax_t tamanhoArquivo = 0;
+    mutable bool terminaEmNovaLinha = true;
+    mutable std::size_t linhasMortas = 0;   // versões antigas + linhas @D
+    // chamar com offsetsMtx travado
+    void indexarOffsets() const;
+    void invalidarOffsets();
+    // Acrescenta uma linha e devolve o offset dela; chamar com offsetsMtx
+    // travado e o índice em dia (indexarOffsets).
+    std::streamoff acrescentarLinha(const std::string& linha);
 
-    static std::vector<std::string> splitCsv(const std::string& line);
+    // Carga paralela do list(): o arquivo é lido inteiro, cortado em
+    // pedaços alinhados em '\n' e cada pedaço vira Disciplinas numa thread
+    // do pool. A junção é sequencial, na ordem do arquivo, aplicando as
+    // operações do modo LOG na posição em que aparecem, então os ids
+    // continuam sendo os de linha. Erros trazem a linha do arquivo: cada
+    // pedaço conta as suas e a junção soma as dos anteriores.
+    // Abaixo de CARGA_PARALELA_MIN_BYTES (ou com cargaThreads <= 1) é um
+    // pedaço só, na própria thread. O pool só é criado na primeira carga
+    // grande: arquivos pequenos nunca sobem threads.
+    static constexpr std::size_t CARGA_PARALELA_MIN_BYTES = 1 << 20;
+    std::size_t cargaThreads = 0;
+    mutable std::mutex cargaPoolMtx;
+    mutable std::unique_ptr<ThreadPool> cargaPool;
+    ThreadPool& poolCarga() const;
+
+    struct OperacaoCarga
+    {
+        std::size_t antes = 0;   // registros do pedaço antes dela
+        std::size_t linha = 0;   // linha dentro do pedaço (1-based)
+        char tipo = 0;
+        int id = 0;
+        Disciplina registro;     // só no 'U'
+    };
+    struct PedacoCarga
+    {
+        std::string_view texto;
+        std::vector<Disciplina> registros;
+        std::vector<OperacaoCarga> operacoes;
+        std::size_t linhas = 0;      // linhas do pedaço, vazias inclusive
+        std::size_t linhaErro = 0;   // 0 = sem erro
+        std::string erro;
+    };
+    // Não lança: o erro fica em linhaErro/erro (o pool descarta exceções).
+    static void carregarPedaco(PedacoCarga& p);
+    std::vector<Disciplina> carregar(std::string_view conteudo) const;
+
+    // o inverso, csvToDisciplina, fica no CsvTokenizer
+    static std::string disciplinaToCsv(const Disciplina& d);
 };
 
 #endif // CSV_DISCIPLINA_REPOSITORY_HPP
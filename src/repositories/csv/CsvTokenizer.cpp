@@ -0,0 +1,203 @@
+#include "CsvTokenizer.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+
+#include "Errors.hpp"
+
+namespace {
+    // mesmo conjunto do isspace usado pelo trim
+    bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    std::string_view trimView(std::string_view s)
+    {
+        size_t ini = 0;
+        size_t fim = s.size();
+        while (ini < fim && isBlank(s[ini]))
+            ++ini;
+        while (fim > ini && isBlank(s[fim - 1]))
+            --fim;
+        return s.substr(ini, fim - ini);
+    }
+
+    // stoi/stod aceitavam sinal '+'; from_chars não
+    std::string_view numero(std::string_view s)
+    {
+        s = trimView(s);
+        if (s.size() > 1 && s[0] == '+' && s[1] != '-')
+            s.remove_prefix(1);
+        return s;
+    }
+}
+
+std::string CsvField::value() const
+{
+    if (!escaped)
+        return std::string(text);
+
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        out.push_back(text[i]);
+        if (text[i] == '"')
+            ++i;   // "" -> "
+    }
+    return out;
+}
+
+int splitCsvFields(std::string_view line, CsvField* out, int max)
+{
+    const size_t len = line.size();
+    size_t i = 0;
+    int n = 0;
+
+    for (;;)
+    {
+        CsvField f;
+
+        size_t ini = i;
+        while (ini < len && isBlank(line[ini]))
+            ++ini;
+
+        if (ini < len && line[ini] == '"')
+        {
+            size_t j = ini + 1;
+            for (;;)
+            {
+                const size_t q = line.find('"', j);
+                if (q == std::string_view::npos)
+                    return -1;
+                if (q + 1 < len && line[q + 1] == '"')
+                {
+                    f.escaped = true;
+                    j = q + 2;
+                    continue;
+                }
+                f.text = line.substr(ini + 1, q - ini - 1);
+                i = q + 1;
+                break;
+            }
+            while (i < len && isBlank(line[i]))
+                ++i;
+            if (i < len && line[i] != ',')
+                return -1;
+        }
+        else
+        {
+            size_t fim = line.find(',', i);
+            if (fim == std::string_view::npos)
+                fim = len;
+            f.text = trimView(line.substr(i, fim - i));
+            i = fim;
+        }
+
+        if (n < max)
+            out[n] = f;
+        ++n;
+
+        if (i >= len)
+            return n;
+        ++i;   // vírgula
+    }
+}
+
+bool parseCsvInt(std::string_view s, int& out)
+{
+    s = numero(s);
+    if (s.empty())
+        return false;
+
+    const char* fim = s.data() + s.size();
+    const auto r = std::from_chars(s.data(), fim, out);
+    return r.ec == std::errc() && r.ptr == fim;
+}
+
+bool parseCsvDouble(std::string_view s, double& out)
+{
+    s = numero(s);
+    if (s.empty())
+        return false;
+
+#if defined(__cpp_lib_to_chars)
+    const char* fim = s.data() + s.size();
+    const auto r = std::from_chars(s.data(), fim, out);
+    return r.ec == std::errc() && r.ptr == fim;
+#else
+    // bibliotecas sem from_chars de ponto flutuante: strtod precisa de
+    // uma string terminada em '\0'
+    char buf[64];
+    if (s.size() >= sizeof(buf))
+        return false;
+    std::memcpy(buf, s.data(), s.size());
+    buf[s.size()] = '\0';
+    char* fim = nullptr;
+    out = std::strtod(buf, &fim);
+    return fim == buf + s.size();
+#endif
+}
+
+void writeCsvField(std::ostream& os, std::string_view value)
+{
+    bool aspas = !value.empty() &&
+                 (value.front() == '@' || isBlank(value.front()) || isBlank(value.back()));
+    for (char c : value)
+    {
+        if (c == '\n' || c == '\r')
+            throw BusinessError("Quebra de linha nao permitida em campo do CSV.");
+        if (c == ',' || c == '"')
+            aspas = true;
+    }
+
+    if (!aspas)
+    {
+        os << value;
+        return;
+    }
+
+    os << '"';
+    for (char c : value)
+    {
+        if (c == '"')
+            os << '"';
+        os << c;
+    }
+    os << '"';
+}
+
+Disciplina csvToDisciplina(std::string_view line, int id)
+{
+    CsvField cols[7];
+    const int n = splitCsvFields(line, cols, 7);
+
+    if (n < 0)
+        throw ConversionError("Linha CSV invalida: aspas mal formadas.");
+    if (n != 7)
+        throw ConversionError("Linha CSV invalida: quantidade de colunas diferente de 7.");
+
+    int semestre = 0, ano = 0, creditos = 0;
+    double nota1 = 0.0, nota2 = 0.0;
+    if (!parseCsvInt(cols[2].text, semestre) ||
+        !parseCsvInt(cols[3].text, ano) ||
+        !parseCsvInt(cols[4].text, creditos) ||
+        !parseCsvDouble(cols[5].text, nota1) ||
+        !parseCsvDouble(cols[6].text, nota2))
+        throw ConversionError("Falha ao converter campos numericos do CSV de disciplina.");
+
+    Disciplina d;
+    d.setId(id);
+    d.setMatricula(cols[0].value());
+    d.setNome(cols[1].value());
+    d.setSemestre(semestre);
+    d.setAno(ano);
+    d.setCreditos(creditos);
+    d.setNota1(nota1);
+    d.setNota2(nota2);
+
+    return d;
+}
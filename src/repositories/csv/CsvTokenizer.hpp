@@ -0,0 +1,51 @@
+#ifndef CSV_TOKENIZER_HPP
+#define CSV_TOKENIZER_HPP
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+#include "Disciplina.hpp"
+
+// Tokenizador de linhas CSV do CsvDisciplinaRepository.
+//
+// - Sem alocação: os campos são string_view sobre a própria linha; só o
+//   valor final (matrícula, nome) vira std::string.
+// - Aspas da RFC 4180: um campo que começa com '"' vai até a aspa de
+//   fechamento e "" dentro dele é uma aspa literal. Aspa no meio de um
+//   campo sem aspas é texto comum, então arquivos antigos continuam
+//   legíveis.
+// - Espaços nas pontas de um campo sem aspas são descartados (como o trim
+//   de antes); entre aspas são preservados.
+// - Quebra de linha dentro de campo não é suportada: o repositório é
+//   orientado a linhas (offsets, log de operações) e a gravação a recusa.
+// - Números com std::from_chars: sem locale e sem exceção; o campo
+//   inteiro precisa ser consumido ("7abc" é erro, o stoi aceitava).
+
+struct CsvField
+{
+    std::string_view text;   // sem as aspas externas
+    bool escaped = false;    // tem "" a desfazer
+
+    std::string value() const;
+};
+
+// Divide 'line' gravando até 'max' campos em 'out'. Devolve o total de
+// campos da linha (pode passar de 'max', para checar a quantidade) ou -1
+// se a linha estiver mal formada (aspa sem fechamento, texto depois dela).
+int splitCsvFields(std::string_view line, CsvField* out, int max);
+
+bool parseCsvInt(std::string_view s, int& out);
+bool parseCsvDouble(std::string_view s, double& out);
+
+// Linha do CSV de disciplinas (matrícula, nome, semestre, ano, créditos,
+// nota1, nota2) -> Disciplina com o id dado. ConversionError se a linha
+// estiver mal formada. É o parsing do repositório; o benchmark usa o mesmo.
+Disciplina csvToDisciplina(std::string_view line, int id);
+
+// Grava 'value' entre aspas quando precisa: vírgula, aspa, espaço nas
+// pontas ou '@' no início (não confundir com uma linha de operação).
+// BusinessError se tiver quebra de linha (dado que o CSV não guarda).
+void writeCsvField(std::ostream& os, std::string_view value);
+
+#endif // CSV_TOKENIZER_HPP
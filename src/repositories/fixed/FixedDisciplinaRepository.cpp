@@ -7,6 +7,7 @@
 #include <iomanip>
 
 #include "Errors.hpp"
+#include "Uteis.hpp"
 
 using namespace std;
 
@@ -23,6 +24,13 @@ FixedDisciplinaRepository::FixedDisciplinaRepository(ILogger& aLog,
     filename = conf.getFileName("txt");
 
     LOG_INF("FixedDisciplinaRepository arquivo=", filename);
+    try {
+        indexar();
+    }
+    catch (const std::exception& e) {
+        // arquivo ilegível agora: exist() tenta de novo e propaga o erro
+        LOG_ERR("fixed: falha ao indexar ", filename, ": ", e.what());
+    }
 }
 
 FixedDisciplinaRepository::~FixedDisciplinaRepository() = default;
@@ -264,6 +272,7 @@ int FixedDisciplinaRepository::insert(const Disciplina& disciplina)
         }
     }
 
+    const bool indexado = indice.isCurrent(revision());
     int total = getRecordCount();
     int newId = total + 1;
 
@@ -277,6 +286,10 @@ int FixedDisciplinaRepository::insert(const Disciplina& disciplina)
 
     if (!out)
         throw InfraError("Falha ao gravar nova disciplina no arquivo fixed.");
+    out.close();
+
+    indice.onInsert(newId, fromLine(line, newId));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("fixed.insert ok id=", newId);
     return newId;
@@ -286,12 +299,15 @@ void FixedDisciplinaRepository::update(int id, const Disciplina& disciplina)
 {
     LOG_DBG("fixed.update id=", id, " novo_nome=", disciplina.getNome());
 
+    const bool indexado = indice.isCurrent(revision());
     int total = getRecordCount();
     if (id <= 0 || id > total)
         throw InfraError("Disciplina nao encontrada para atualizacao (id=" + std::to_string(id) + ")");
 
     std::string line = toLine(disciplina);
     writeLineAt(id, line);
+    indice.onUpdate(id, fromLine(line, id));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("fixed.update ok id=", id);
 }
@@ -300,6 +316,7 @@ void FixedDisciplinaRepository::remove(int id)
 {
     LOG_DBG("fixed.remove id=", id);
 
+    const bool indexado = indice.isCurrent(revision());
     int total = getRecordCount();
     if (id <= 0 || id > total)
         throw InfraError("Disciplina nao encontrada para remocao (id=" + std::to_string(id) + ")");
@@ -326,6 +343,9 @@ void FixedDisciplinaRepository::remove(int id)
     if (ec)
         throw InfraError("Falha ao truncar arquivo fixed na remocao.");
 
+    indice.onRemoveSwapLast(id, total);
+    indice.afterWrite(indexado, revision());
+
     LOG_DBG("fixed.remove ok id=", id, " total_antigo=", total, " total_novo=", total - 1);
 }
 
@@ -376,43 +396,27 @@ bool FixedDisciplinaRepository::exist(const std::string& matricula,
     LOG_DBG("fixed.exist matricula=", matricula,
             " ano=", ano, " semestre=", semestre);
 
-    int total = getRecordCount();
-    if (total == 0)
-        return false;
-
-    std::ifstream in(filename, ios::binary);
-    if (!in)
-        return false;
-
-    for (int id = 1; id <= total; ++id)
+    indexar();
+    int id = indice.find(matricula, ano, semestre);
+    if (id != 0)
     {
-        char buffer[RECORD_NO_EOL_LEN];
-        char nl;
-
-        in.read(buffer, RECORD_NO_EOL_LEN);
-        if (!in)
-            throw InfraError("Erro ao ler registro em exist().");
-
-        in.read(&nl, 1);
-        if (!in)
-            throw InfraError("Erro ao ler newline em exist().");
-
-        std::string line(buffer, RECORD_NO_EOL_LEN);
-        Disciplina d = fromLine(line, id);
-
-        if (d.getMatricula() == matricula &&
-            d.getAno()       == ano &&
-            d.getSemestre()  == semestre)
-        {
-            LOG_DBG("fixed.exist true id=", id);
-            return true;
-        }
+        LOG_DBG("fixed.exist true id=", id);
+        return true;
     }
 
     LOG_DBG("fixed.exist false");
     return false;
 }
 
+void FixedDisciplinaRepository::indexar() const
+{
+    const std::uint64_t rev = revision();
+    if (indice.isCurrent(rev))
+        return;
+    indice.rebuild(list(), rev);
+    LOG_DBG("fixed.indexar registros=", indice.size());
+}
+
 bool FixedDisciplinaRepository::exist(int id) const
 {
     LOG_DBG("fixed.exist(id) id=", id);
@@ -421,3 +425,8 @@ bool FixedDisciplinaRepository::exist(int id) const
     LOG_DBG(ok ? "true" : "false");
     return ok;
 }
+
+std::uint64_t FixedDisciplinaRepository::revision() const
+{
+    return fileRevision(filename);
+}
@@ -8,6 +8,7 @@
 #include "IDisciplinaRepository.hpp"
 #include "Disciplina.hpp"
 #include "Configuracao.hpp"
+#include "DisciplinaIndex.hpp"
 
 class FixedDisciplinaRepository : public IDisciplinaRepository
 {
@@ -23,10 +24,18 @@ public:
     bool exist(const std::string& matricula, int ano, int semestre) const override;
     bool exist(int id) const; // se já existir no contrato, isso implementa
 
+    // mtime + tamanho do arquivo: detecta também gravações de fora
+    std::uint64_t revision() const override;
+
 private:
     ILogger& log;
     std::string filename;
 
+    // (matricula, ano, semestre) -> id: exist() sem varrer o arquivo
+    mutable DisciplinaIndex indice;
+    // Deixa 'indice' em dia com o arquivo (reconstrói se mudou por fora).
+    void indexar() const;
+
     static constexpr int MATRICULA_LEN = 20;
     static constexpr int NOME_LEN      = 60;
     static constexpr int SEMESTRE_LEN  = 1;
@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "Errors.hpp"
+#include "Uteis.hpp"
 
 using namespace std;
 
@@ -13,6 +14,13 @@ JsonDisciplinaRepository::JsonDisciplinaRepository(ILogger& aLog,
     , filename(conf.getFileName("json"))
 {
     LOG_INF("JsonDisciplinaRepository arquivo=", filename);
+    try {
+        indexar();
+    }
+    catch (const std::exception& e) {
+        // arquivo ilegível agora: exist() tenta de novo e propaga o erro
+        LOG_ERR("json: falha ao indexar ", filename, ": ", e.what());
+    }
 }
 
 JsonDisciplinaRepository::~JsonDisciplinaRepository() = default;
@@ -23,6 +31,9 @@ JsonDisciplinaRepository::~JsonDisciplinaRepository() = default;
 
 JsonDisciplinaRepository::Json JsonDisciplinaRepository::loadAll() const
 {
+    if (batch)
+        return *batch;
+
     std::ifstream in(filename);
     if (!in.good())
     {
@@ -62,6 +73,48 @@ void JsonDisciplinaRepository::saveAll(const Json& data) const
         throw InfraError("Falha ao finalizar escrita do arquivo JSON de disciplinas.");
 }
 
+JsonDisciplinaRepository::Json& JsonDisciplinaRepository::document(Json& local) const
+{
+    if (batch)
+        return *batch;
+    local = loadAll();
+    return local;
+}
+
+void JsonDisciplinaRepository::persist(const Json& data) const
+{
+    if (!batch)
+        saveAll(data);
+}
+
+// --------------------------------------------------------
+// Lote
+// --------------------------------------------------------
+
+void JsonDisciplinaRepository::beginBatch()
+{
+    LOG_DBG("json.beginBatch");
+    batch = std::make_unique<Json>(loadAll());
+}
+
+void JsonDisciplinaRepository::commitBatch()
+{
+    if (!batch)
+        return;
+    const bool indexado = indice.isCurrent(revision());
+    std::unique_ptr<Json> data = std::move(batch);
+    saveAll(*data);
+    indice.afterWrite(indexado, revision());
+    LOG_DBG("json.commitBatch registros=", data->size());
+}
+
+void JsonDisciplinaRepository::rollbackBatch()
+{
+    LOG_DBG("json.rollbackBatch");
+    batch.reset();
+    indice.invalidate();   // tinha as operações descartadas
+}
+
 // --------------------------------------------------------
 // Map Disciplina <-> Json
 // --------------------------------------------------------
@@ -141,12 +194,16 @@ int JsonDisciplinaRepository::insert(const Disciplina& disciplina)
 {
     LOG_DBG("json.insert nome=", disciplina.getNome());
 
-    Json data = loadAll();
+    const bool indexado = indice.isCurrent(revision());
+    Json local;
+    Json& data = document(local);
 
     data.push_back(toJson(disciplina));
     int newId = static_cast<int>(data.size());
 
-    saveAll(data);
+    persist(data);
+    indice.onInsert(newId, disciplina);
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("json.insert ok id=", newId);
     return newId;
@@ -159,12 +216,16 @@ void JsonDisciplinaRepository::update(int id, const Disciplina& disciplina)
     if (id <= 0)
         throw InfraError("Id invalido para update (id=" + std::to_string(id) + ")");
 
-    Json data = loadAll();
+    const bool indexado = indice.isCurrent(revision());
+    Json local;
+    Json& data = document(local);
     if (id > static_cast<int>(data.size()))
         throw InfraError("Disciplina nao encontrada para update (id=" + std::to_string(id) + ")");
 
     data[static_cast<size_t>(id - 1)] = toJson(disciplina);
-    saveAll(data);
+    persist(data);
+    indice.onUpdate(id, disciplina);
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("json.update ok id=", id);
 }
@@ -176,7 +237,9 @@ void JsonDisciplinaRepository::remove(int id)
     if (id <= 0)
         throw InfraError("Id invalido para remocao (id=" + std::to_string(id) + ")");
 
-    Json data = loadAll();
+    const bool indexado = indice.isCurrent(revision());
+    Json local;
+    Json& data = document(local);
     int total = static_cast<int>(data.size());
 
     if (total == 0 || id > total)
@@ -190,7 +253,9 @@ void JsonDisciplinaRepository::remove(int id)
 
     data.erase(data.begin() + (total - 1));
 
-    saveAll(data);
+    persist(data);
+    indice.onRemoveSwapLast(id, total);
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("json.remove ok id=", id, " total_antigo=", total, " total_novo=", total - 1);
 }
@@ -221,25 +286,28 @@ bool JsonDisciplinaRepository::exist(const std::string& matricula,
     LOG_DBG("json.exist m=", matricula,
             " ano=", ano, " sem=", semestre);
 
-    Json data = loadAll();
-    int id = 1;
-    for (const auto& item : data)
+    indexar();
+    int id = indice.find(matricula, ano, semestre);
+    if (id != 0)
     {
-        Disciplina d = fromJson(item, id);
-        if (d.getMatricula() == matricula &&
-            d.getAno()       == ano &&
-            d.getSemestre()  == semestre)
-        {
-            LOG_DBG("json.exist true id=", id);
-            return true;
-        }
-        ++id;
+        LOG_DBG("json.exist true id=", id);
+        return true;
     }
 
     LOG_DBG("json.exist false");
     return false;
 }
 
+void JsonDisciplinaRepository::indexar() const
+{
+    // no lote, revision() é a do arquivo e list() já traz o documento do lote
+    const std::uint64_t rev = revision();
+    if (indice.isCurrent(rev))
+        return;
+    indice.rebuild(list(), rev);
+    LOG_DBG("json.indexar registros=", indice.size());
+}
+
 bool JsonDisciplinaRepository::exist(int id) const
 {
     LOG_DBG("json.exist(id) id=", id);
@@ -248,3 +316,8 @@ bool JsonDisciplinaRepository::exist(int id) const
     LOG_DBG(ok ? "true" : "false");
     return ok;
 }
+
+std::uint64_t JsonDisciplinaRepository::revision() const
+{
+    return fileRevision(filename);
+}
@@ -1,6 +1,7 @@
 #ifndef JSON_DISCIPLINA_REPOSITORY_HPP
 #define JSON_DISCIPLINA_REPOSITORY_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,7 @@
 #include "IDisciplinaRepository.hpp"
 #include "Disciplina.hpp"
 #include "Configuracao.hpp"
+#include "DisciplinaIndex.hpp"
 
 // nlohmann::json (header-only) em external/json/json.hpp
 #include "json.hpp"
@@ -27,15 +29,36 @@ public:
 
     bool exist(int id) const; // se estiver no contrato base, isso implementa
 
+    // mtime + tamanho do arquivo: detecta também gravações de fora
+    std::uint64_t revision() const override;
+
+    void beginBatch() override;
+    void commitBatch() override;
+    void rollbackBatch() override;
+
 private:
     using Json = nlohmann::json;
 
     ILogger&    log;
     std::string filename;
 
+    // documento do lote em andamento (nullptr fora de lote): as operações
+    // alteram só a memória e commitBatch grava o arquivo uma vez
+    std::unique_ptr<Json> batch;
+
+    // (matricula, ano, semestre) -> id: exist() sem ler o arquivo
+    mutable DisciplinaIndex indice;
+    // Deixa 'indice' em dia com o arquivo (reconstrói se mudou por fora).
+    void indexar() const;
+
     Json loadAll() const;
     void saveAll(const Json& data) const;
 
+    // Documento a alterar: o do lote, ou 'local' carregado do arquivo.
+    Json& document(Json& local) const;
+    // Grava 'data', exceto durante um lote.
+    void persist(const Json& data) const;
+
     static Json        toJson(const Disciplina& d);
     static Disciplina  fromJson(const Json& j, int id);
 
@@ -7,7 +7,7 @@
 using namespace std;
 
 MemoryDisciplinaRepository::MemoryDisciplinaRepository(ILogger& aLog, const Configuracao& conf)
-    : log(aLog), qtd(0), lastId(0)
+    : log(aLog), qtd(0), lastId(0), revisao(1)
 {
 }
 
@@ -51,6 +51,8 @@ int MemoryDisciplinaRepository::insert(const Disciplina& disciplina)
     vet[qtd].setId(++lastId);
     LOG_DBG("pos=", qtd, " id=", lastId, " qtd_nova=", qtd + 1)
     qtd++;
+    ++revisao;
+    indice.onInsert(lastId, disciplina);
     return lastId;
 }
 
@@ -68,6 +70,8 @@ void MemoryDisciplinaRepository::remove(int id)
     for (int i = idx; i < qtd - 1; i++)
         vet[i] = vet[i + 1];
     qtd--;
+    ++revisao;
+    indice.onRemove(id);
     LOG_DBG("qtd_restante=", qtd)
 }
 
@@ -83,20 +87,20 @@ void MemoryDisciplinaRepository::update(int id, const Disciplina& disciplina)
     LOG_DBG("idx=", idx)
     vet[idx] = disciplina;
     vet[idx].setId(id);
+    ++revisao;
+    indice.onUpdate(id, disciplina);
     LOG_DBG("ok")
 }
 
 bool MemoryDisciplinaRepository::exist(const std::string& matricula, int ano, int semestre) const
 {
     LOG_DBG("matricula=", matricula, " ano=", ano, " semestre=", semestre)
-    for (int i = 0; i < qtd; i++)
-        if (vet[i].getMatricula() == matricula &&
-            vet[i].getAno()       == ano &&
-            vet[i].getSemestre()  == semestre)
-        {
-            LOG_DBG("retorna true, achou idx=", i, " id=", vet[i].getId())
-            return true;
-        }
+    int id = indice.find(matricula, ano, semestre);
+    if (id != 0)
+    {
+        LOG_DBG("retorna true, achou id=", id)
+        return true;
+    }
     LOG_DBG("retorna false, nao achou")
     return false;
 }
@@ -135,4 +139,9 @@ double Historico::cr() const
 
     return (somaCreditos == 0)? 0.0 : somaPonderada / somaCreditos;
 }
-*/
\ No newline at end of file
+*/
+
+std::uint64_t MemoryDisciplinaRepository::revision() const
+{
+    return revisao;
+}
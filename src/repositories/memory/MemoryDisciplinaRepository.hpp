@@ -7,6 +7,7 @@
 #include"Disciplina.hpp"
 #include"IDisciplinaRepository.hpp"
 #include"Configuracao.hpp"
+#include"DisciplinaIndex.hpp"
 
 const int MAX_DISCIPLINAS=100; 
 
@@ -17,6 +18,8 @@ class MemoryDisciplinaRepository : public IDisciplinaRepository
         Disciplina vet[MAX_DISCIPLINAS];
         int        qtd;
         int        lastId;
+        std::uint64_t revisao;   // incrementada a cada gravação
+        DisciplinaIndex indice;  // (matricula, ano, semestre) -> id
         int obterIndice(int id) const; 
     public:
         MemoryDisciplinaRepository(ILogger& aLog, const Configuracao& conf);
@@ -29,5 +32,6 @@ class MemoryDisciplinaRepository : public IDisciplinaRepository
         std::vector<Disciplina> list() const;
         bool exist(const std::string& matricula, int ano, int semestre) const;
         bool exist(int id) const;
+        std::uint64_t revision() const;
 };
 #endif
\ No newline at end of file
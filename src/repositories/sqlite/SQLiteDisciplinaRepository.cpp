@@ -1,7 +1,10 @@
 #include "SQLiteDisciplinaRepository.hpp"
 
+#include <initializer_list>
+#include <iterator>
 #include <stdexcept>
 #include <sstream>
+#include <variant>
 
 #include "Errors.hpp"
 
@@ -21,6 +24,104 @@ static void checkSqlite(int rc, sqlite3* db, const char* msg)
     }
 }
 
+// sqlite3_exec de um ou mais comandos, sem linhas de resultado
+static void execSql(sqlite3* db, const char* sql, const std::string& msg)
+{
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK)
+    {
+        std::string err = errMsg ? errMsg : "erro desconhecido";
+        sqlite3_free(errMsg);
+        throw InfraError(msg + ": " + err);
+    }
+}
+
+// Migrações do schema: MIGRACOES[i] leva o banco da versão i para i + 1.
+// A versão fica em PRAGMA user_version; bancos anteriores a este controle
+// (tabela já criada, user_version = 0) passam por todas, por isso cada
+// passo precisa ser idempotente (IF NOT EXISTS).
+static const char* const MIGRACOES[] = {
+    // 1: tabela
+    "CREATE TABLE IF NOT EXISTS disciplinas ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  matricula TEXT NOT NULL,"
+    "  nome TEXT NOT NULL,"
+    "  semestre INTEGER NOT NULL,"
+    "  ano INTEGER NOT NULL,"
+    "  creditos INTEGER NOT NULL,"
+    "  nota1 REAL NOT NULL,"
+    "  nota2 REAL NOT NULL"
+    ");",
+
+    // 2: unicidade de negócio (exist() vira uma busca no índice) e
+    //    filtros/agrupamentos por período
+    "CREATE UNIQUE INDEX IF NOT EXISTS ux_disciplinas_chave "
+    "  ON disciplinas (matricula, ano, semestre);"
+    "CREATE INDEX IF NOT EXISTS ix_disciplinas_periodo "
+    "  ON disciplinas (ano, semestre);",
+};
+
+static const int SCHEMA_VERSION = static_cast<int>(std::size(MIGRACOES));
+
+// SQL dos statements fixos, na ordem de StmtId
+static const char* const SQL_STMTS[] = {
+    // StGet
+    "SELECT id, matricula, nome, semestre, ano, creditos, nota1, nota2 "
+    "FROM disciplinas WHERE id = ?;",
+
+    // StInsert
+    "INSERT INTO disciplinas "
+    "(matricula, nome, semestre, ano, creditos, nota1, nota2) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?);",
+
+    // StUpdate
+    "UPDATE disciplinas SET "
+    "matricula = ?, "
+    "nome = ?, "
+    "semestre = ?, "
+    "ano = ?, "
+    "creditos = ?, "
+    "nota1 = ?, "
+    "nota2 = ? "
+    "WHERE id = ?;",
+
+    // StRemove
+    "DELETE FROM disciplinas WHERE id = ?;",
+
+    // StList
+    "SELECT id, matricula, nome, semestre, ano, creditos, nota1, nota2 "
+    "FROM disciplinas "
+    "ORDER BY id;",
+
+    // StExistChave
+    "SELECT 1 FROM disciplinas "
+    "WHERE matricula = ? AND ano = ? AND semestre = ? "
+    "LIMIT 1;",
+
+    // StExistId
+    "SELECT 1 FROM disciplinas WHERE id = ? LIMIT 1;",
+
+    // StStatistics: agregado no banco, uma linha por (ano, semestre, faixa
+    // da media); so sobem para a aplicacao no maximo 10 linhas por periodo
+    "SELECT ano, semestre, "
+    "       MAX(MIN(CAST((nota1 + nota2) / 2.0 AS INTEGER), 9), 0) AS faixa, "
+    "       COUNT(*), "
+    "       SUM(CASE WHEN creditos > 0 THEN creditos ELSE 0 END), "
+    "       SUM(CASE WHEN creditos > 0 THEN (nota1 + nota2) / 2.0 * creditos ELSE 0 END), "
+    "       SUM((nota1 + nota2) / 2.0), "
+    "       MIN((nota1 + nota2) / 2.0), "
+    "       MAX((nota1 + nota2) / 2.0) "
+    "FROM disciplinas "
+    "GROUP BY ano, semestre, faixa "
+    "ORDER BY ano, semestre;",
+
+    // StDataVersion
+    "PRAGMA data_version;",
+};
+
+static_assert(std::size(SQL_STMTS) == 9, "SQL_STMTS deve seguir StmtId");
+
 // --------------------------------------------------------
 // Construtor / Destrutor
 // --------------------------------------------------------
@@ -29,11 +130,21 @@ SQLiteDisciplinaRepository::SQLiteDisciplinaRepository(ILogger& aLog,
                                                        const Configuracao& conf)
     : log(aLog)
     , filename(conf.getConnectionString())
-    , db(nullptr)
 {
     LOG_INF("SQLiteDisciplinaRepository abrindo banco: ", filename);
     openDatabase();
-    ensureSchema();
+    try
+    {
+        configureConnection(conf);
+        ensureSchema();
+        writer.prepareStatements();
+        openReaders(conf);
+    }
+    catch (...)
+    {
+        closeDatabase();
+        throw;
+    }
 }
 
 SQLiteDisciplinaRepository::~SQLiteDisciplinaRepository()
@@ -47,6 +158,7 @@ SQLiteDisciplinaRepository::~SQLiteDisciplinaRepository()
 
 void SQLiteDisciplinaRepository::openDatabase()
 {
+    sqlite3*& db = writer.db;
     int rc = sqlite3_open(filename.c_str(), &db);
     if (rc != SQLITE_OK)
     {
@@ -57,50 +169,329 @@ void SQLiteDisciplinaRepository::openDatabase()
         throw InfraError("Falha ao abrir banco SQLite: " + err);
     }
 
-    // Modo mais previsível em caso de acesso concorrente (mesmo que aqui não tenha):
+    // Leitores e outros processos podem estar usando o banco ao mesmo tempo
     sqlite3_busy_timeout(db, 2000);
 }
 
-void SQLiteDisciplinaRepository::closeDatabase()
+void SQLiteDisciplinaRepository::openReaders(const Configuracao& conf)
 {
-    if (db)
+    // banco em memória: cada conexão teria o seu próprio banco vazio
+    if (filename.empty() || filename == ":memory:")
+        return;
+
+    std::ostringstream pragmas;
+    pragmas << "PRAGMA query_only = 1;"
+            << "PRAGMA mmap_size = "  << conf.getSqliteMmapSize() << ";"
+            << "PRAGMA cache_size = " << conf.getSqliteCacheSize() << ";"
+            << "PRAGMA temp_store = " << conf.getSqliteTempStore() << ";";
+
+    const int n = conf.getSqliteReadConnections();
+    for (int i = 0; i < n; ++i)
     {
-        int rc = sqlite3_close(db);
+        auto c = std::make_unique<Connection>();
+        // NOMUTEX: a conexão é usada por uma thread de cada vez (ConnLease)
+        int rc = sqlite3_open_v2(filename.c_str(), &c->db,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
         if (rc != SQLITE_OK)
         {
-            // Aqui não vamos jogar exceção em destrutor, só logar se tiver mecanismo.
-            // Se quiser: LOG_ERR("Falha ao fechar SQLite: ", sqlite3_errmsg(db));
+            std::string err = c->db ? sqlite3_errmsg(c->db) : "erro desconhecido";
+            c->close();
+            throw InfraError("Falha ao abrir conexao de leitura SQLite: " + err);
+        }
+        sqlite3_busy_timeout(c->db, 2000);
+        try
+        {
+            execSql(c->db, pragmas.str().c_str(), "Falha ao configurar conexao de leitura SQLite");
+            c->prepareStatements();
         }
+        catch (...)
+        {
+            c->close();
+            throw;
+        }
+        freeReaders.push_back(c.get());
+        readers.push_back(std::move(c));
+    }
+    LOG_INF("sqlite: conexoes de leitura=", readers.size());
+}
+
+void SQLiteDisciplinaRepository::closeDatabase()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMtx);
+        freeReaders.clear();
+    }
+    for (auto& c : readers)
+        c->close();
+    readers.clear();
+    writer.close();
+}
+
+SQLiteDisciplinaRepository::ConnLease SQLiteDisciplinaRepository::reader() const
+{
+    // a thread que está num lote lê pela conexão do lote
+    if (readers.empty() || batchOwner.load() == std::this_thread::get_id())
+        return ConnLease(this, &writer, false);
+
+    std::unique_lock<std::mutex> lock(poolMtx);
+    poolCv.wait(lock, [this]{ return !freeReaders.empty(); });
+    Connection* c = freeReaders.back();
+    freeReaders.pop_back();
+    return ConnLease(this, c, true);
+}
+
+void SQLiteDisciplinaRepository::release(Connection* c) const
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMtx);
+        freeReaders.push_back(c);
+    }
+    poolCv.notify_one();
+}
+
+namespace {
+    // só valores conhecidos vão para o texto do PRAGMA
+    bool oneOf(const std::string& v, std::initializer_list<const char*> options)
+    {
+        for (const char* o : options)
+            if (v == o)
+                return true;
+        return false;
+    }
+}
+
+void SQLiteDisciplinaRepository::configureConnection(const Configuracao& conf)
+{
+    const std::string& journal = conf.getSqliteJournalMode();
+    const std::string& sync    = conf.getSqliteSynchronous();
+    const std::string& temp    = conf.getSqliteTempStore();
+
+    if (!oneOf(journal, {"WAL", "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "OFF"}))
+        throw InfraError("SQLITE_JOURNAL_MODE invalido: " + journal);
+    if (!oneOf(sync, {"OFF", "NORMAL", "FULL", "EXTRA"}))
+        throw InfraError("SQLITE_SYNCHRONOUS invalido: " + sync);
+    if (!oneOf(temp, {"DEFAULT", "FILE", "MEMORY"}))
+        throw InfraError("SQLITE_TEMP_STORE invalido: " + temp);
+
+    // WAL: leitores não bloqueiam o escritor e, com synchronous=NORMAL, o
+    // fsync acontece no checkpoint e não a cada transação. A durabilidade
+    // de uma queda de energia cobre até a última transação antes do
+    // último checkpoint; a integridade do banco continua garantida.
+    std::ostringstream sql;
+    sql << "PRAGMA journal_mode = " << journal << ";"
+        << "PRAGMA synchronous = "   << sync << ";"
+        << "PRAGMA mmap_size = "     << conf.getSqliteMmapSize() << ";"
+        << "PRAGMA cache_size = "    << conf.getSqliteCacheSize() << ";"
+        << "PRAGMA temp_store = "    << temp << ";";
+    execSql(writer.db, sql.str().c_str(), "Falha ao configurar conexao SQLite");
+
+    LOG_INF("sqlite: journal_mode=", journal, " synchronous=", sync,
+            " mmap_size=", conf.getSqliteMmapSize(), " cache_size=", conf.getSqliteCacheSize(),
+            " temp_store=", temp);
+}
+
+// --------------------------------------------------------
+// Lote (transacao)
+// --------------------------------------------------------
+
+void SQLiteDisciplinaRepository::beginBatch()
+{
+    LOG_DBG("sqlite.beginBatch");
+    // segura as gravações de outras threads até o commit/rollback
+    std::unique_lock<std::recursive_mutex> lock(writeMtx);
+    if (inBatch)
+        throw InfraError("Lote SQLite ja iniciado (lotes aninhados nao sao suportados).");
+    // IMMEDIATE: pega o lock de escrita já no início, em vez de falhar com
+    // SQLITE_BUSY no meio do lote
+    execSql(writer.db, "BEGIN IMMEDIATE;", "Falha ao iniciar lote SQLite");
+    inBatch = true;
+    batchOwner = std::this_thread::get_id();
+    lock.release();
+}
+
+void SQLiteDisciplinaRepository::commitBatch()
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMtx);
+    if (!inBatch)
+        return;
+    // se o COMMIT falhar o lote continua aberto: quem chamou faz o rollback
+    execSql(writer.db, "COMMIT;", "Falha ao gravar lote SQLite");
+    inBatch = false;
+    batchOwner = std::thread::id();
+    writeMtx.unlock();   // o lock do beginBatch
+    LOG_DBG("sqlite.commitBatch");
+}
+
+void SQLiteDisciplinaRepository::rollbackBatch()
+{
+    LOG_DBG("sqlite.rollbackBatch");
+    std::lock_guard<std::recursive_mutex> lock(writeMtx);
+    if (!inBatch)
+        return;
+    inBatch = false;
+    batchOwner = std::thread::id();
+    // sem exceção: normalmente já estamos tratando a falha que causou o rollback
+    char* errMsg = nullptr;
+    if (sqlite3_exec(writer.db, "ROLLBACK;", nullptr, nullptr, &errMsg) != SQLITE_OK)
+        LOG_ERR("sqlite.rollbackBatch falhou: ", errMsg ? errMsg : "erro desconhecido");
+    sqlite3_free(errMsg);
+    writeMtx.unlock();   // o lock do beginBatch
+}
+
+// --------------------------------------------------------
+// Cache de statements
+// --------------------------------------------------------
+
+void SQLiteDisciplinaRepository::Connection::prepareStatements()
+{
+    for (int i = 0; i < StmtCount; ++i)
+    {
+        // PERSISTENT: ficam abertos durante toda a vida da conexao
+        int rc = sqlite3_prepare_v3(db, SQL_STMTS[i], -1, SQLITE_PREPARE_PERSISTENT,
+                                    &stmts[i].stmt, nullptr);
+        checkSqlite(rc, db, "Falha ao preparar statement");
+    }
+}
+
+void SQLiteDisciplinaRepository::Connection::close()
+{
+    // statements abertos impedem o sqlite3_close
+    for (auto& s : stmts)
+    {
+        sqlite3_finalize(s.stmt);
+        s.stmt = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dynMtx);
+        for (auto& [sql, s] : dynStmts)
+            sqlite3_finalize(s->stmt);
+        dynStmts.clear();
+    }
+
+    if (db)
+    {
+        // sem exceção aqui: chamado também pelo destrutor
+        sqlite3_close(db);
         db = nullptr;
     }
 }
 
+SQLiteDisciplinaRepository::StmtLease SQLiteDisciplinaRepository::Connection::lease(StmtId id)
+{
+    return StmtLease(stmts[id]);
+}
+
+SQLiteDisciplinaRepository::StmtLease SQLiteDisciplinaRepository::Connection::lease(const std::string& sql)
+{
+    CachedStmt* cached = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(dynMtx);
+        auto& slot = dynStmts[sql];
+        if (!slot)
+        {
+            auto novo = std::make_unique<CachedStmt>();
+            int rc = sqlite3_prepare_v3(db, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT,
+                                        &novo->stmt, nullptr);
+            if (rc != SQLITE_OK)
+            {
+                dynStmts.erase(sql);
+                checkSqlite(rc, db, "Falha ao preparar statement de query()");
+            }
+            slot = std::move(novo);
+        }
+        cached = slot.get();
+    }
+    // o CachedStmt não sai do map enquanto a conexao estiver aberta
+    return StmtLease(*cached);
+}
+
 // --------------------------------------------------------
 // Schema
 // --------------------------------------------------------
 
+int SQLiteDisciplinaRepository::schemaVersion() const
+{
+    sqlite3* db = writer.db;
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr);
+    checkSqlite(rc, db, "Falha ao preparar PRAGMA user_version");
+
+    int version = 0;
+    rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW)
+        version = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    checkSqlite(rc, db, "Falha ao ler PRAGMA user_version");
+    return version;
+}
+
 void SQLiteDisciplinaRepository::ensureSchema() const
 {
+    sqlite3* db = writer.db;
+    // caminho comum: banco já na versão atual, sem pegar lock de escrita
+    if (schemaVersion() == SCHEMA_VERSION)
+        return;
+
+    // IMMEDIATE: outro processo abrindo o mesmo banco espera e, depois,
+    // encontra a versão já atualizada
+    execSql(db, "BEGIN IMMEDIATE;", "Falha ao iniciar migracao do schema");
+    try
+    {
+        int version = schemaVersion();
+        if (version > SCHEMA_VERSION)
+            throw InfraError("Banco SQLite com schema versao " + std::to_string(version) +
+                             ", mais novo que o suportado (" + std::to_string(SCHEMA_VERSION) + ").");
+
+        for (; version < SCHEMA_VERSION; ++version)
+        {
+            if (version + 1 == 2)
+                checkUniqueKeys();
+            execSql(db, MIGRACOES[version],
+                    "Falha ao migrar schema para versao " + std::to_string(version + 1));
+            LOG_INF("sqlite: schema migrado para versao ", version + 1);
+        }
+
+        const std::string setVersion = "PRAGMA user_version = " + std::to_string(SCHEMA_VERSION) + ";";
+        execSql(db, setVersion.c_str(), "Falha ao gravar versao do schema");
+        execSql(db, "COMMIT;", "Falha ao concluir migracao do schema");
+    }
+    catch (...)
+    {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+}
+
+void SQLiteDisciplinaRepository::checkUniqueKeys() const
+{
+    sqlite3* db = writer.db;
+    // o índice único não pode ser criado sobre chaves já repetidas: avisa
+    // qual é, em vez do "UNIQUE constraint failed" do SQLite
     const char* sql =
-        "CREATE TABLE IF NOT EXISTS disciplinas ("
-        "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        "  matricula TEXT NOT NULL,"
-        "  nome TEXT NOT NULL,"
-        "  semestre INTEGER NOT NULL,"
-        "  ano INTEGER NOT NULL,"
-        "  creditos INTEGER NOT NULL,"
-        "  nota1 REAL NOT NULL,"
-        "  nota2 REAL NOT NULL"
-        ");";
+        "SELECT matricula, ano, semestre, COUNT(*) FROM disciplinas "
+        "GROUP BY matricula, ano, semestre HAVING COUNT(*) > 1 LIMIT 1;";
 
-    char* errMsg = nullptr;
-    int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK)
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    checkSqlite(rc, db, "Falha ao preparar verificacao de chaves repetidas");
+
+    rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW)
     {
-        std::string msg = errMsg ? errMsg : "erro desconhecido";
-        sqlite3_free(errMsg);
-        throw InfraError("Falha ao criar tabela disciplinas: " + msg);
+        const unsigned char* mat = sqlite3_column_text(stmt, 0);
+        std::ostringstream oss;
+        oss << "Banco SQLite com disciplinas repetidas (matricula="
+            << (mat ? reinterpret_cast<const char*>(mat) : "")
+            << ", ano=" << sqlite3_column_int(stmt, 1)
+            << ", semestre=" << sqlite3_column_int(stmt, 2)
+            << ", " << sqlite3_column_int(stmt, 3) << " registros): "
+            << "corrija antes de atualizar o schema.";
+        sqlite3_finalize(stmt);
+        throw InfraError(oss.str());
     }
+    sqlite3_finalize(stmt);
+    checkSqlite(rc, db, "Falha na verificacao de chaves repetidas");
 }
 
 // --------------------------------------------------------
@@ -142,27 +533,23 @@ Disciplina SQLiteDisciplinaRepository::get(int id) const
 {
     LOG_DBG("sqlite.get id=", id);
 
-    const char* sql =
-        "SELECT id, matricula, nome, semestre, ano, creditos, nota1, nota2 "
-        "FROM disciplinas WHERE id = ?;";
-
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar SELECT em get()");
+    ConnLease c = reader();
+    sqlite3* db = c->db;
+    StmtLease st = c->lease(StGet);
+    sqlite3_stmt* stmt = st.get();
 
-    rc = sqlite3_bind_int(stmt, 1, id);
+    int rc = sqlite3_bind_int(stmt, 1, id);
     checkSqlite(rc, db, "Falha ao bind id em get()");
 
     rc = sqlite3_step(stmt);
     if (rc == SQLITE_ROW)
     {
         Disciplina d = mapRowToDisciplina(stmt);
-        sqlite3_finalize(stmt);
         LOG_DBG("sqlite.get ok id=", id, " nome=", d.getNome());
         return d;
     }
+    checkSqlite(rc, db, "Erro em get()");
 
-    sqlite3_finalize(stmt);
     throw InfraError("Disciplina nao encontrada (id=" + std::to_string(id) + ")");
 }
 
@@ -174,17 +561,13 @@ int SQLiteDisciplinaRepository::insert(const Disciplina& disciplina)
 {
     LOG_DBG("sqlite.insert nome=", disciplina.getNome());
 
-    const char* sql =
-        "INSERT INTO disciplinas "
-        "(matricula, nome, semestre, ano, creditos, nota1, nota2) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?);";
-
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar INSERT");
+    std::lock_guard<std::recursive_mutex> lock(writeMtx);
+    sqlite3* db = writer.db;
+    StmtLease st = writer.lease(StInsert);
+    sqlite3_stmt* stmt = st.get();
 
     int idx = 1;
-    rc = sqlite3_bind_text (stmt, idx++, disciplina.getMatricula().c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_bind_text (stmt, idx++, disciplina.getMatricula().c_str(), -1, SQLITE_TRANSIENT);
     checkSqlite(rc, db, "Falha ao bind matricula em INSERT");
 
     rc = sqlite3_bind_text (stmt, idx++, disciplina.getNome().c_str(), -1, SQLITE_TRANSIENT);
@@ -208,8 +591,6 @@ int SQLiteDisciplinaRepository::insert(const Disciplina& disciplina)
     rc = sqlite3_step(stmt);
     checkSqlite(rc, db, "Falha ao executar INSERT");
 
-    sqlite3_finalize(stmt);
-
     int newId = static_cast<int>(sqlite3_last_insert_rowid(db));
     LOG_DBG("sqlite.insert ok id=", newId);
     return newId;
@@ -223,23 +604,13 @@ void SQLiteDisciplinaRepository::update(int id, const Disciplina& disciplina)
 {
     LOG_DBG("sqlite.update id=", id, " novo_nome=", disciplina.getNome());
 
-    const char* sql =
-        "UPDATE disciplinas SET "
-        "matricula = ?, "
-        "nome = ?, "
-        "semestre = ?, "
-        "ano = ?, "
-        "creditos = ?, "
-        "nota1 = ?, "
-        "nota2 = ? "
-        "WHERE id = ?;";
-
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar UPDATE");
+    std::lock_guard<std::recursive_mutex> lock(writeMtx);
+    sqlite3* db = writer.db;
+    StmtLease st = writer.lease(StUpdate);
+    sqlite3_stmt* stmt = st.get();
 
     int idx = 1;
-    rc = sqlite3_bind_text (stmt, idx++, disciplina.getMatricula().c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_bind_text (stmt, idx++, disciplina.getMatricula().c_str(), -1, SQLITE_TRANSIENT);
     checkSqlite(rc, db, "bind matricula UPDATE");
 
     rc = sqlite3_bind_text (stmt, idx++, disciplina.getNome().c_str(), -1, SQLITE_TRANSIENT);
@@ -265,15 +636,9 @@ void SQLiteDisciplinaRepository::update(int id, const Disciplina& disciplina)
 
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE)
-    {
-        sqlite3_finalize(stmt);
         checkSqlite(rc, db, "Falha ao executar UPDATE");
-    }
-
-    int changes = sqlite3_changes(db);
-    sqlite3_finalize(stmt);
 
-    if (changes == 0)
+    if (sqlite3_changes(db) == 0)
         throw InfraError("Disciplina nao encontrada para atualizacao (id=" + std::to_string(id) + ")");
 
     LOG_DBG("sqlite.update ok id=", id);
@@ -287,26 +652,19 @@ void SQLiteDisciplinaRepository::remove(int id)
 {
     LOG_DBG("sqlite.remove id=", id);
 
-    const char* sql = "DELETE FROM disciplinas WHERE id = ?;";
+    std::lock_guard<std::recursive_mutex> lock(writeMtx);
+    sqlite3* db = writer.db;
+    StmtLease st = writer.lease(StRemove);
+    sqlite3_stmt* stmt = st.get();
 
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar DELETE");
-
-    rc = sqlite3_bind_int(stmt, 1, id);
+    int rc = sqlite3_bind_int(stmt, 1, id);
     checkSqlite(rc, db, "bind id DELETE");
 
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE)
-    {
-        sqlite3_finalize(stmt);
         checkSqlite(rc, db, "Falha ao executar DELETE");
-    }
-
-    int changes = sqlite3_changes(db);
-    sqlite3_finalize(stmt);
 
-    if (changes == 0)
+    if (sqlite3_changes(db) == 0)
         throw InfraError("Disciplina nao encontrada para remocao (id=" + std::to_string(id) + ")");
 
     LOG_DBG("sqlite.remove ok id=", id);
@@ -322,34 +680,181 @@ std::vector<Disciplina> SQLiteDisciplinaRepository::list() const
 
     std::vector<Disciplina> out;
 
-    const char* sql =
-        "SELECT id, matricula, nome, semestre, ano, creditos, nota1, nota2 "
-        "FROM disciplinas "
-        "ORDER BY id;";
-
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar SELECT em list()");
+    ConnLease c = reader();
+    sqlite3* db = c->db;
+    StmtLease st = c->lease(StList);
+    sqlite3_stmt* stmt = st.get();
 
+    int rc;
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
     {
         out.push_back(mapRowToDisciplina(stmt));
     }
 
     if (rc != SQLITE_DONE)
-    {
-        sqlite3_finalize(stmt);
         checkSqlite(rc, db, "Erro em iteracao de list()");
-    }
-
-    sqlite3_finalize(stmt);
 
     LOG_DBG("sqlite.list retornou=", out.size());
     return out;
 }
 
 // --------------------------------------------------------
-// exist(matricula, ano, semestre)
+// query: filtros, ordenacao e paginacao feitos pelo SQLite
+// --------------------------------------------------------
+
+namespace {
+    using SqlParam = std::variant<int, double, std::string>;
+
+    void bindParams(sqlite3_stmt* stmt, sqlite3* db, const std::vector<SqlParam>& params)
+    {
+        int idx = 1;
+        for (const auto& p : params)
+        {
+            int rc;
+            if (auto i = std::get_if<int>(&p))
+                rc = sqlite3_bind_int(stmt, idx++, *i);
+            else if (auto d = std::get_if<double>(&p))
+                rc = sqlite3_bind_double(stmt, idx++, *d);
+            else
+                rc = sqlite3_bind_text(stmt, idx++, std::get<std::string>(p).c_str(), -1, SQLITE_TRANSIENT);
+            checkSqlite(rc, db, "bind parametro em query()");
+        }
+    }
+
+    const char* sortColumn(DisciplinaSort s)
+    {
+        switch (s)
+        {
+            case DisciplinaSort::Matricula: return "matricula";
+            case DisciplinaSort::Nome:      return "nome";
+            case DisciplinaSort::Ano:       return "ano";
+            case DisciplinaSort::Semestre:  return "semestre";
+            case DisciplinaSort::Creditos:  return "creditos";
+            case DisciplinaSort::Media:     return "(nota1 + nota2) / 2.0";
+            case DisciplinaSort::Id:        break;
+        }
+        return nullptr;
+    }
+
+    // escapa % e _ para uso em LIKE ... ESCAPE '\'
+    std::string likeEscape(const std::string& s)
+    {
+        std::string out;
+        for (char c : s)
+        {
+            if (c == '%' || c == '_' || c == '\\')
+                out.push_back('\\');
+            out.push_back(c);
+        }
+        return out;
+    }
+}
+
+DisciplinaPage SQLiteDisciplinaRepository::query(const DisciplinaQuery& q) const
+{
+    LOG_DBG("sqlite.query limit=", q.limit, " offset=", q.offset);
+
+    std::string where = " WHERE 1=1";
+    std::vector<SqlParam> params;
+    if (!q.matricula.empty()) { where += " AND matricula = ?"; params.emplace_back(q.matricula); }
+    if (!q.nome.empty())      { where += " AND nome LIKE ? ESCAPE '\\'"; params.emplace_back("%" + likeEscape(q.nome) + "%"); }
+    if (q.ano)                { where += " AND ano = ?";       params.emplace_back(*q.ano); }
+    if (q.semestre)           { where += " AND semestre = ?";  params.emplace_back(*q.semestre); }
+    if (q.mediaMin)           { where += " AND (nota1 + nota2) / 2.0 >= ?"; params.emplace_back(*q.mediaMin); }
+    if (q.mediaMax)           { where += " AND (nota1 + nota2) / 2.0 <= ?"; params.emplace_back(*q.mediaMax); }
+
+    DisciplinaPage page;
+    // COUNT e pagina na mesma conexao
+    ConnLease c = reader();
+    sqlite3* db = c->db;
+
+    // total (antes da paginacao)
+    {
+        StmtLease st = c->lease("SELECT COUNT(*) FROM disciplinas" + where + ";");
+        sqlite3_stmt* stmt = st.get();
+        bindParams(stmt, db, params);
+        int rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW)
+            page.total = sqlite3_column_int(stmt, 0);
+        checkSqlite(rc, db, "Falha ao executar COUNT em query()");
+    }
+
+    // pagina
+    const char* dir = q.desc ? " DESC" : " ASC";
+    std::string sql =
+        "SELECT id, matricula, nome, semestre, ano, creditos, nota1, nota2 "
+        "FROM disciplinas" + where + " ORDER BY ";
+    if (const char* col = sortColumn(q.sort))
+        sql += std::string(col) + dir + ", ";
+    sql += std::string("id") + dir + " LIMIT ? OFFSET ?;";
+    params.emplace_back(q.limit);   // LIMIT negativo = sem limite no SQLite
+    params.emplace_back(q.offset < 0 ? 0 : q.offset);
+
+    StmtLease st = c->lease(sql);
+    sqlite3_stmt* stmt = st.get();
+    bindParams(stmt, db, params);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        page.items.push_back(mapRowToDisciplina(stmt));
+    }
+
+    if (rc != SQLITE_DONE)
+        checkSqlite(rc, db, "Erro em iteracao de query()");
+
+    LOG_DBG("sqlite.query retornou=", page.items.size(), " total=", page.total);
+    return page;
+}
+
+// --------------------------------------------------------
+// statistics: agregado por periodo
+// --------------------------------------------------------
+
+DisciplinaEstatisticas SQLiteDisciplinaRepository::statistics() const
+{
+    LOG_DBG("sqlite.statistics");
+
+    ConnLease c = reader();
+    sqlite3* db = c->db;
+    StmtLease st = c->lease(StStatistics);
+    sqlite3_stmt* stmt = st.get();
+
+    DisciplinaEstatisticas e;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const int ano      = sqlite3_column_int(stmt, 0);
+        const int semestre = sqlite3_column_int(stmt, 1);
+        if (e.periodos.empty() || e.periodos.back().ano != ano || e.periodos.back().semestre != semestre)
+        {
+            EstatisticasPeriodo p;
+            p.ano = ano;
+            p.semestre = semestre;
+            e.periodos.push_back(p);
+        }
+
+        EstatisticasGrupo faixa;
+        faixa.disciplinas   = sqlite3_column_int(stmt, 3);
+        faixa.creditos      = sqlite3_column_int(stmt, 4);
+        faixa.somaPonderada = sqlite3_column_double(stmt, 5);
+        faixa.somaMedias    = sqlite3_column_double(stmt, 6);
+        faixa.mediaMin      = sqlite3_column_double(stmt, 7);
+        faixa.mediaMax      = sqlite3_column_double(stmt, 8);
+        faixa.distribuicao[sqlite3_column_int(stmt, 2)] = faixa.disciplinas;
+        merge(e.periodos.back().periodo, faixa);
+    }
+
+    if (rc != SQLITE_DONE)
+        checkSqlite(rc, db, "Erro em iteracao de statistics()");
+
+    fillAcumulados(e);
+    LOG_DBG("sqlite.statistics periodos=", e.periodos.size());
+    return e;
+}
+
+// --------------------------------------------------------
+// exist(matricula, ano, semestre): busca em ux_disciplinas_chave
 // --------------------------------------------------------
 
 bool SQLiteDisciplinaRepository::exist(const std::string& matricula,
@@ -359,17 +864,13 @@ bool SQLiteDisciplinaRepository::exist(const std::string& matricula,
     LOG_DBG("sqlite.exist m=", matricula,
             " ano=", ano, " sem=", semestre);
 
-    const char* sql =
-        "SELECT 1 FROM disciplinas "
-        "WHERE matricula = ? AND ano = ? AND semestre = ? "
-        "LIMIT 1;";
-
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar SELECT em exist(m,a,s)");
+    ConnLease c = reader();
+    sqlite3* db = c->db;
+    StmtLease st = c->lease(StExistChave);
+    sqlite3_stmt* stmt = st.get();
 
     int idx = 1;
-    rc = sqlite3_bind_text(stmt, idx++, matricula.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_bind_text(stmt, idx++, matricula.c_str(), -1, SQLITE_TRANSIENT);
     checkSqlite(rc, db, "bind matricula exist");
 
     rc = sqlite3_bind_int(stmt, idx++, ano);
@@ -379,17 +880,9 @@ bool SQLiteDisciplinaRepository::exist(const std::string& matricula,
     checkSqlite(rc, db, "bind semestre exist");
 
     rc = sqlite3_step(stmt);
+    checkSqlite(rc, db, "Erro em exist(m,a,s)");
 
     bool found = (rc == SQLITE_ROW);
-
-    if (rc != SQLITE_ROW && rc != SQLITE_DONE)
-    {
-        sqlite3_finalize(stmt);
-        checkSqlite(rc, db, "Erro em exist(m,a,s)");
-    }
-
-    sqlite3_finalize(stmt);
-
     LOG_DBG("sqlite.exist(m,a,s) = ", found ? "true" : "false");
     return found;
 }
@@ -398,28 +891,34 @@ bool SQLiteDisciplinaRepository::exist(int id) const
 {
     LOG_DBG("sqlite.exist(id) id=", id);
 
-    const char* sql =
-        "SELECT 1 FROM disciplinas WHERE id = ? LIMIT 1;";
-
-    sqlite3_stmt* stmt = nullptr;
-    int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-    checkSqlite(rc, db, "Falha ao preparar SELECT em exist(id)");
+    ConnLease c = reader();
+    sqlite3* db = c->db;
+    StmtLease st = c->lease(StExistId);
+    sqlite3_stmt* stmt = st.get();
 
-    rc = sqlite3_bind_int(stmt, 1, id);
+    int rc = sqlite3_bind_int(stmt, 1, id);
     checkSqlite(rc, db, "bind id exist(id)");
 
     rc = sqlite3_step(stmt);
+    checkSqlite(rc, db, "Erro em exist(id)");
 
     bool found = (rc == SQLITE_ROW);
+    LOG_DBG("sqlite.exist(id) = ", found ? "true" : "false");
+    return found;
+}
 
-    if (rc != SQLITE_ROW && rc != SQLITE_DONE)
+std::uint64_t SQLiteDisciplinaRepository::revision() const
+{
+    std::uint64_t dataVersion = 0;
     {
-        sqlite3_finalize(stmt);
-        checkSqlite(rc, db, "Erro em exist(id)");
+        StmtLease st = writer.lease(StDataVersion);
+        int rc = sqlite3_step(st.get());
+        if (rc == SQLITE_ROW)
+            dataVersion = (std::uint64_t)sqlite3_column_int64(st.get(), 0);
+        else
+            checkSqlite(rc, writer.db, "Erro em PRAGMA data_version");
     }
 
-    sqlite3_finalize(stmt);
-
-    LOG_DBG("sqlite.exist(id) = ", found ? "true" : "false");
-    return found;
-}
+    // data_version não muda com as gravações da própria conexão
+    return (dataVersion << 32) ^ (std::uint64_t)(std::uint32_t)sqlite3_total_changes(writer.db);
+}
\ No newline at end of file
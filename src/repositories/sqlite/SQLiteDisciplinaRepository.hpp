@@ -1,7 +1,14 @@
 #ifndef SQLITE_DISCIPLINA_REPOSITORY_HPP
 #define SQLITE_DISCIPLINA_REPOSITORY_HPP
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "ILogger.hpp"
@@ -24,18 +31,130 @@ public:
     void update(int id, const Disciplina& disciplina) override;
     void remove(int id) override;
     std::vector<Disciplina> list() const override;
+    DisciplinaPage query(const DisciplinaQuery& q) const override;
+    DisciplinaEstatisticas statistics() const override;
     bool exist(const std::string& matricula, int ano, int semestre) const override;
 
     bool exist(int id) const; // se estiver no contrato base, isso implementa
 
+    // data_version (gravações de outras conexões) + total_changes (desta)
+    std::uint64_t revision() const override;
+
+    // Lote = uma transação (BEGIN IMMEDIATE ... COMMIT): um único fsync
+    // no commit em vez de um por gravação.
+    void beginBatch() override;
+    void commitBatch() override;
+    void rollbackBatch() override;
+
 private:
     ILogger&    log;
     std::string filename;
-    sqlite3*    db;
+
+    // Statements preparados uma vez e reaproveitados: cada chamada só faz
+    // reset + novo bind. Um sqlite3_stmt não pode ser usado por duas
+    // threads ao mesmo tempo, por isso cada um tem seu mutex.
+    struct CachedStmt
+    {
+        sqlite3_stmt* stmt = nullptr;
+        std::mutex    mtx;
+    };
+
+    // Uso exclusivo de um CachedStmt; ao sair faz reset e limpa os binds,
+    // também quando o uso termina por exceção.
+    class StmtLease
+    {
+    public:
+        explicit StmtLease(CachedStmt& c) : lock(c.mtx), stmt(c.stmt) {}
+        StmtLease(StmtLease&& o) noexcept : lock(std::move(o.lock)), stmt(o.stmt) { o.stmt = nullptr; }
+        ~StmtLease()
+        {
+            if (stmt)
+            {
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+            }
+        }
+        sqlite3_stmt* get() const { return stmt; }
+
+    private:
+        std::unique_lock<std::mutex> lock;
+        sqlite3_stmt* stmt;
+    };
+
+    // statements fixos, preparados na abertura
+    enum StmtId
+    {
+        StGet, StInsert, StUpdate, StRemove, StList,
+        StExistChave, StExistId, StStatistics, StDataVersion,
+        StmtCount
+    };
+
+    // Uma conexão com o seu cache de statements.
+    struct Connection
+    {
+        sqlite3* db = nullptr;
+        std::array<CachedStmt, StmtCount> stmts;
+
+        // statements de query(): o SQL depende dos filtros e da ordenação
+        // usados, então são preparados no primeiro uso de cada combinação
+        // (um conjunto pequeno e limitado)
+        std::mutex dynMtx;
+        std::unordered_map<std::string, std::unique_ptr<CachedStmt>> dynStmts;
+
+        void prepareStatements();
+        void close();
+        StmtLease lease(StmtId id);
+        StmtLease lease(const std::string& sql);
+    };
+
+    // Conexão emprestada para uma leitura: devolvida ao pool no destrutor.
+    class ConnLease
+    {
+    public:
+        ConnLease(const SQLiteDisciplinaRepository* aRepo, Connection* aConn, bool aPooled)
+            : repo(aRepo), conn(aConn), pooled(aPooled) {}
+        ConnLease(ConnLease&& o) noexcept : repo(o.repo), conn(o.conn), pooled(o.pooled) { o.pooled = false; }
+        ~ConnLease() { if (pooled) repo->release(conn); }
+        Connection* operator->() const { return conn; }
+
+    private:
+        const SQLiteDisciplinaRepository* repo;
+        Connection* conn;
+        bool pooled;
+    };
+
+    // Uma conexão de escrita e um pool de conexões somente leitura.
+    //
+    // - Em WAL cada leitura vê o último commit sem bloquear o escritor, e
+    //   leituras de threads diferentes rodam em paralelo, cada uma na sua
+    //   conexão (SQLITE_READ_CONNECTIONS).
+    // - Gravações usam só 'writer' e são serializadas por writeMtx; um lote
+    //   segura writeMtx do beginBatch ao commit/rollback.
+    // - Durante um lote, as leituras da thread do lote vão para 'writer',
+    //   para enxergar o que ela ainda não gravou.
+    // - Sem pool (0 conexões ou banco em memória), tudo usa 'writer'.
+    mutable Connection writer;
+    std::vector<std::unique_ptr<Connection>> readers;
+    mutable std::vector<Connection*> freeReaders;
+    mutable std::mutex poolMtx;
+    mutable std::condition_variable poolCv;
+
+    std::recursive_mutex writeMtx;
+    std::atomic<std::thread::id> batchOwner{};
+    bool inBatch = false;
+
+    ConnLease reader() const;
+    void release(Connection* c) const;
 
     void openDatabase();
+    void openReaders(const Configuracao& conf);
     void closeDatabase();
+    // PRAGMAs do perfil de desempenho (Configuracao::getSqlite*)
+    void configureConnection(const Configuracao& conf);
+    // Cria o schema ou atualiza um banco existente (PRAGMA user_version).
     void ensureSchema() const;
+    int  schemaVersion() const;
+    void checkUniqueKeys() const;
 
     static Disciplina mapRowToDisciplina(sqlite3_stmt* stmt);
 };
@@ -4,6 +4,7 @@
 #include <stdexcept>
 
 #include "Errors.hpp"
+#include "Uteis.hpp"
 
 using namespace std;
 
@@ -20,6 +21,13 @@ XmlDisciplinaRepository::XmlDisciplinaRepository(ILogger& aLog,
     , filename(conf.getFileName("xml"))
 {
     LOG_INF("XmlDisciplinaRepository arquivo=", filename);
+    try {
+        indexar();
+    }
+    catch (const std::exception& e) {
+        // arquivo ilegível agora: exist() tenta de novo e propaga o erro
+        LOG_ERR("xml: falha ao indexar ", filename, ": ", e.what());
+    }
 }
 
 XmlDisciplinaRepository::~XmlDisciplinaRepository() = default;
@@ -63,6 +71,50 @@ void XmlDisciplinaRepository::saveDocument(const XmlDoc& doc) const
         throw InfraError("Falha ao gravar XML de disciplinas no arquivo.");
 }
 
+XmlDisciplinaRepository::XmlDoc& XmlDisciplinaRepository::document(XmlDoc& local) const
+{
+    if (batch)
+        return *batch;
+    loadDocument(local);
+    return local;
+}
+
+void XmlDisciplinaRepository::persist(const XmlDoc& doc) const
+{
+    if (!batch)
+        saveDocument(doc);
+}
+
+// --------------------------------------------------------
+// Lote
+// --------------------------------------------------------
+
+void XmlDisciplinaRepository::beginBatch()
+{
+    LOG_DBG("xml.beginBatch");
+    auto doc = std::make_unique<XmlDoc>();
+    loadDocument(*doc);
+    batch = std::move(doc);
+}
+
+void XmlDisciplinaRepository::commitBatch()
+{
+    if (!batch)
+        return;
+    const bool indexado = indice.isCurrent(revision());
+    std::unique_ptr<XmlDoc> doc = std::move(batch);
+    saveDocument(*doc);
+    indice.afterWrite(indexado, revision());
+    LOG_DBG("xml.commitBatch");
+}
+
+void XmlDisciplinaRepository::rollbackBatch()
+{
+    LOG_DBG("xml.rollbackBatch");
+    batch.reset();
+    indice.invalidate();   // tinha as operações descartadas
+}
+
 XmlNode XmlDisciplinaRepository::getRoot(XmlDoc& doc)
 {
     XmlNode root = doc.child("disciplinas");
@@ -179,8 +231,8 @@ Disciplina XmlDisciplinaRepository::get(int id) const
 {
     LOG_DBG("xml.get id=", id);
 
-    XmlDoc doc;
-    loadDocument(doc);
+    XmlDoc local;
+    XmlDoc& doc = document(local);
     XmlNode root = getRoot(doc);
 
     XmlNode node = getDisciplinaNodeById(root, id);
@@ -197,8 +249,9 @@ int XmlDisciplinaRepository::insert(const Disciplina& disciplina)
 {
     LOG_DBG("xml.insert nome=", disciplina.getNome());
 
-    XmlDoc doc;
-    loadDocument(doc);
+    const bool indexado = indice.isCurrent(revision());
+    XmlDoc local;
+    XmlDoc& doc = document(local);
     XmlNode root = getRoot(doc);
 
     XmlNode node = root.append_child("disciplina");
@@ -206,7 +259,9 @@ int XmlDisciplinaRepository::insert(const Disciplina& disciplina)
 
     int newId = getRecordCount(root); // posicao do ultimo
 
-    saveDocument(doc);
+    persist(doc);
+    indice.onInsert(newId, makeDisciplinaFromNode(node, newId));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("xml.insert ok id=", newId);
     return newId;
@@ -219,8 +274,9 @@ void XmlDisciplinaRepository::update(int id, const Disciplina& disciplina)
     if (id <= 0)
         throw InfraError("Id invalido para update (id=" + std::to_string(id) + ")");
 
-    XmlDoc doc;
-    loadDocument(doc);
+    const bool indexado = indice.isCurrent(revision());
+    XmlDoc local;
+    XmlDoc& doc = document(local);
     XmlNode root = getRoot(doc);
 
     XmlNode node = getDisciplinaNodeById(root, id);
@@ -228,7 +284,9 @@ void XmlDisciplinaRepository::update(int id, const Disciplina& disciplina)
         throw InfraError("Disciplina nao encontrada para update (id=" + std::to_string(id) + ")");
 
     fillNodeFromDisciplina(node, disciplina);
-    saveDocument(doc);
+    persist(doc);
+    indice.onUpdate(id, makeDisciplinaFromNode(node, id));
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("xml.update ok id=", id);
 }
@@ -240,8 +298,9 @@ void XmlDisciplinaRepository::remove(int id)
     if (id <= 0)
         throw InfraError("Id invalido para remocao (id=" + std::to_string(id) + ")");
 
-    XmlDoc doc;
-    loadDocument(doc);
+    const bool indexado = indice.isCurrent(revision());
+    XmlDoc local;
+    XmlDoc& doc = document(local);
     XmlNode root = getRoot(doc);
 
     int total = getRecordCount(root);
@@ -254,7 +313,9 @@ void XmlDisciplinaRepository::remove(int id)
         XmlNode only = root.child("disciplina");
         if (only)
             root.remove_child(only);
-        saveDocument(doc);
+        persist(doc);
+        indice.onRemove(id);
+        indice.afterWrite(indexado, revision());
         LOG_DBG("xml.remove ok id=", id, " total_novo=0");
         return;
     }
@@ -286,7 +347,9 @@ void XmlDisciplinaRepository::remove(int id)
     // Remove o ultimo
     root.remove_child(last);
 
-    saveDocument(doc);
+    persist(doc);
+    indice.onRemoveSwapLast(id, total);
+    indice.afterWrite(indexado, revision());
 
     LOG_DBG("xml.remove ok id=", id, " total_antigo=", total, " total_novo=", total - 1);
 }
@@ -297,8 +360,8 @@ std::vector<Disciplina> XmlDisciplinaRepository::list() const
 
     std::vector<Disciplina> out;
 
-    XmlDoc doc;
-    loadDocument(doc);
+    XmlDoc local;
+    XmlDoc& doc = document(local);
     XmlNode root = getRoot(doc);
 
     int id = 0;
@@ -319,34 +382,34 @@ bool XmlDisciplinaRepository::exist(const std::string& matricula,
     LOG_DBG("xml.exist m=", matricula,
             " ano=", ano, " sem=", semestre);
 
-    XmlDoc doc;
-    loadDocument(doc);
-    XmlNode root = getRoot(doc);
-
-    int id = 0;
-    for (XmlNode node : root.children("disciplina"))
+    indexar();
+    int id = indice.find(matricula, ano, semestre);
+    if (id != 0)
     {
-        ++id;
-        Disciplina d = makeDisciplinaFromNode(node, id);
-        if (d.getMatricula() == matricula &&
-            d.getAno()       == ano &&
-            d.getSemestre()  == semestre)
-        {
-            LOG_DBG("xml.exist true id=", id);
-            return true;
-        }
+        LOG_DBG("xml.exist true id=", id);
+        return true;
     }
 
     LOG_DBG("xml.exist false");
     return false;
 }
 
+void XmlDisciplinaRepository::indexar() const
+{
+    // no lote, revision() é a do arquivo e list() já traz o documento do lote
+    const std::uint64_t rev = revision();
+    if (indice.isCurrent(rev))
+        return;
+    indice.rebuild(list(), rev);
+    LOG_DBG("xml.indexar registros=", indice.size());
+}
+
 bool XmlDisciplinaRepository::exist(int id) const
 {
     LOG_DBG("xml.exist(id) id=", id);
 
-    XmlDoc doc;
-    loadDocument(doc);
+    XmlDoc local;
+    XmlDoc& doc = document(local);
     XmlNode root = getRoot(doc);
 
     int total = getRecordCount(root);
@@ -355,3 +418,8 @@ bool XmlDisciplinaRepository::exist(int id) const
     LOG_DBG(ok ? "true" : "false");
     return ok;
 }
+
+std::uint64_t XmlDisciplinaRepository::revision() const
+{
+    return fileRevision(filename);
+}
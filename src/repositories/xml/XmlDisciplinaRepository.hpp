@@ -1,6 +1,7 @@
 #ifndef XML_DISCIPLINA_REPOSITORY_HPP
 #define XML_DISCIPLINA_REPOSITORY_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,7 @@
 #include "IDisciplinaRepository.hpp"
 #include "Disciplina.hpp"
 #include "Configuracao.hpp"
+#include "DisciplinaIndex.hpp"
 
 // pugixml (MIT) - header-only + cpp
 #include "pugixml.hpp"
@@ -27,6 +29,13 @@ public:
 
     bool exist(int id) const; // se estiver no contrato base, implementamos aqui
 
+    // mtime + tamanho do arquivo: detecta também gravações de fora
+    std::uint64_t revision() const override;
+
+    void beginBatch() override;
+    void commitBatch() override;
+    void rollbackBatch() override;
+
 private:
     using XmlDoc  = pugi::xml_document;
     using XmlNode = pugi::xml_node;
@@ -34,10 +43,24 @@ private:
     ILogger&    log;
     std::string filename;
 
+    // documento do lote em andamento (nullptr fora de lote): as operações
+    // alteram só a memória e commitBatch grava o arquivo uma vez
+    std::unique_ptr<XmlDoc> batch;
+
+    // (matricula, ano, semestre) -> id: exist() sem ler o arquivo
+    mutable DisciplinaIndex indice;
+    // Deixa 'indice' em dia com o arquivo (reconstrói se mudou por fora).
+    void indexar() const;
+
     // Carrega ou cria documento com raiz <disciplinas>.
     void loadDocument(XmlDoc& doc) const;
     void saveDocument(const XmlDoc& doc) const;
 
+    // Documento a usar: o do lote, ou 'local' carregado do arquivo.
+    XmlDoc& document(XmlDoc& local) const;
+    // Grava 'doc', exceto durante um lote.
+    void persist(const XmlDoc& doc) const;
+
     static XmlNode getRoot(XmlDoc& doc);
 
     static XmlNode      getDisciplinaNodeById(XmlNode root, int id);
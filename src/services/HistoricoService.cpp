@@ -3,9 +3,11 @@
 #include "IDisciplinaRepository.hpp"
 #include "Errors.hpp"
 
+#include <algorithm>
 #include <ctime>
 #include <cctype>
 #include <string>
+#include <unordered_map>
 
 HistoricoService::HistoricoService(IDisciplinaRepository& aRepo, ILogger& aLog)
     : repo(aRepo), log(aLog)
@@ -26,8 +28,11 @@ int HistoricoService::insert(const Disciplina& disciplina)
     }
 
     // Repositorio define o id tecnico
+    const bool emDia = somasEmDia();
     int id = repo.insert(disciplina);
+    ajustarSomas(emDia, nullptr, &disciplina);
     LOG_INF("insert: ok, id=", id, " matricula=", disciplina.getMatricula(), " ano=", disciplina.getAno(), " semestre=", disciplina.getSemestre())
+    notificar(DisciplinaEvento::Tipo::Insert, id);
     return id;
 }
 
@@ -58,16 +63,150 @@ void HistoricoService::update(int id, const Disciplina& disciplina)
     Disciplina copia = disciplina;
     copia.setId(id);
 
+    const bool emDia = somasEmDia();
     repo.update(id, copia);
+    ajustarSomas(emDia, &atual, &copia);
     LOG_INF("update: ok, id=", id)
+    notificar(DisciplinaEvento::Tipo::Update, id);
 }
 
 void HistoricoService::remove(int id)
 {
     LOG_DBG("remove: inicio, id=", id)
     // Se nao existir, o repositorio lanca InfraError
-    repo.remove(id);
+    const bool emDia = somasEmDia();
+    if (emDia) {
+        // valores antigos para descontar do CR
+        Disciplina antiga = repo.get(id);
+        repo.remove(id);
+        ajustarSomas(true, &antiga, nullptr);
+    } else {
+        repo.remove(id);
+        ajustarSomas(false, nullptr, nullptr);
+    }
     LOG_INF("remove: ok, id=", id)
+    notificar(DisciplinaEvento::Tipo::Remove, id);
+}
+
+std::vector<int> HistoricoService::applyBatch(const std::vector<DisciplinaOperacao>& ops)
+{
+    using Tipo = DisciplinaOperacao::Tipo;
+    LOG_DBG("applyBatch: inicio, operacoes=", ops.size())
+
+    auto falha = [](size_t i, const std::string& msg) {
+        return BusinessError("Operacao " + std::to_string(i + 1) + ": " + msg);
+    };
+    auto chave = [](const Disciplina& d) {
+        return d.getMatricula() + '\x1f' + std::to_string(d.getAno()) + '/' + std::to_string(d.getSemestre());
+    };
+
+    // Regras de cada disciplina
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (ops[i].tipo == Tipo::Remove)
+            continue;
+        try {
+            validarDisciplina(ops[i].disciplina);
+        }
+        catch (const BusinessError& e) {
+            throw falha(i, e.what());
+        }
+    }
+
+    // Ordem de aplicacao: alteracoes, remocoes (ids decrescentes, pois nos
+    // repositorios posicionais a remocao move o ultimo registro) e inclusoes
+    std::vector<size_t> ordem;
+    ordem.reserve(ops.size());
+    for (Tipo t : {Tipo::Update, Tipo::Remove, Tipo::Insert}) {
+        size_t inicio = ordem.size();
+        for (size_t i = 0; i < ops.size(); ++i)
+            if (ops[i].tipo == t) ordem.push_back(i);
+        if (t == Tipo::Remove)
+            std::stable_sort(ordem.begin() + inicio, ordem.end(),
+                             [&](size_t a, size_t b){ return ops[a].id > ops[b].id; });
+    }
+
+    // Unicidade e existencia: simula o lote sobre o estado atual,
+    // com uma unica leitura do repositorio
+    std::unordered_map<std::string, int> idDaChave;
+    std::unordered_map<int, std::string> chaveDoId;
+    for (const auto& d : repo.list()) {
+        idDaChave[chave(d)] = d.getId();
+        chaveDoId[d.getId()] = chave(d);
+    }
+    for (size_t i : ordem) {
+        const auto& op = ops[i];
+        if (op.tipo == Tipo::Insert) {
+            if (!idDaChave.emplace(chave(op.disciplina), 0).second)
+                throw falha(i, "Ja existe disciplina com esta matricula/ano/semestre.");
+            continue;
+        }
+        auto it = chaveDoId.find(op.id);
+        if (it == chaveDoId.end())
+            throw falha(i, "Disciplina nao encontrada (id=" + std::to_string(op.id) + ").");
+        idDaChave.erase(it->second);
+        if (op.tipo == Tipo::Remove) {
+            chaveDoId.erase(it);
+            continue;
+        }
+        if (!idDaChave.emplace(chave(op.disciplina), op.id).second)
+            throw falha(i, "Ja existe outra disciplina com esta matricula/ano/semestre.");
+        it->second = chave(op.disciplina);
+    }
+
+    // Gravacao: um unico lote no repositorio
+    std::vector<int> ids(ops.size(), 0);
+    repo.beginBatch();
+    try {
+        for (size_t i : ordem) {
+            const auto& op = ops[i];
+            if (op.tipo == Tipo::Insert) {
+                ids[i] = repo.insert(op.disciplina);
+            } else if (op.tipo == Tipo::Update) {
+                Disciplina copia = op.disciplina;
+                copia.setId(op.id);
+                repo.update(op.id, copia);
+                ids[i] = op.id;
+            } else {
+                repo.remove(op.id);
+                ids[i] = op.id;
+            }
+        }
+        repo.commitBatch();
+    }
+    catch (...) {
+        repo.rollbackBatch();
+        ajustarSomas(false, nullptr, nullptr);
+        throw;
+    }
+    // refeitas na proxima consulta ao CR
+    ajustarSomas(false, nullptr, nullptr);
+    // o lote confirmado vai para o disco antes de responder
+    repo.flush();
+
+    // Nos repositorios posicionais a remocao move o ultimo registro para o
+    // lugar do removido, inclusive um que acabou de ser alterado: o id
+    // final das alteracoes sai da chave, com uma leitura a mais
+    bool temAlteracao = false, temRemocao = false;
+    for (const auto& op : ops) {
+        temAlteracao = temAlteracao || op.tipo == Tipo::Update;
+        temRemocao = temRemocao || op.tipo == Tipo::Remove;
+    }
+    if (temAlteracao && temRemocao) {
+        std::unordered_map<std::string, int> idFinal;
+        for (const auto& d : repo.list())
+            idFinal[chave(d)] = d.getId();
+        for (size_t i = 0; i < ops.size(); ++i) {
+            if (ops[i].tipo != Tipo::Update)
+                continue;
+            auto it = idFinal.find(chave(ops[i].disciplina));
+            if (it != idFinal.end())
+                ids[i] = it->second;
+        }
+    }
+    LOG_INF("applyBatch: ok, operacoes=", ops.size())
+    if (!ops.empty())
+        notificar(DisciplinaEvento::Tipo::Reset, 0);
+    return ids;
 }
 
 namespace {
@@ -97,40 +236,123 @@ std::vector<Disciplina> HistoricoService::list() const
     return lst;
 }
 
+DisciplinaPage HistoricoService::query(const DisciplinaQuery& q) const
+{
+    LOG_DBG("query: inicio, limit=", q.limit, " offset=", q.offset);
+    if (q.offset < 0)
+        throw BusinessError("Offset invalido. Deve ser maior ou igual a 0.");
+    auto page = repo.query(q);
+    for(Disciplina& d : page.items)
+       d.setMedia(calcularMedia(d));
+    LOG_INF("query: retornou ", page.items.size(), " de ", page.total, " disciplinas");
+    return page;
+}
+
 double HistoricoService::calculateCR() const
 {
     LOG_DBG("calculateCR: inicio")
-    const auto disciplinas = repo.list();
+    std::lock_guard<std::mutex> lock(crMtx);
+    if (!somasEmDia())
+        reconstruirSomas();
 
-    if (disciplinas.empty()) {
-        LOG_DBG("calculateCR: sem disciplinas, retorno 0.0")
+    if (somas.creditos == 0) {
+        LOG_DBG("calculateCR: somaCreditos=0, retorno 0.0")
         return 0.0;
     }
+    double cr = somas.ponderada / static_cast<double>(somas.creditos);
+    LOG_INF("calculateCR: ok, CR=", cr, " (disciplinas=", somas.disciplinas, ", somaCreditos=", somas.creditos, ")")
+    return cr;
+}
 
-    double somaPonderada = 0.0;
-    int somaCreditos = 0;
+DisciplinaEstatisticas HistoricoService::statistics() const
+{
+    LOG_DBG("statistics: inicio")
+    auto e = repo.statistics();
+    LOG_INF("statistics: ok, periodos=", e.periodos.size(), " disciplinas=", e.geral.disciplinas)
+    return e;
+}
 
-    for (const auto& d : disciplinas) {
-        const int creditos = d.getCreditos();
-        if (creditos <= 0) {
-            continue; // ignora registros com creditos invalidos
-        }
+void HistoricoService::setChangeListener(ChangeListener aListener)
+{
+    listener = std::move(aListener);
+}
 
-        const double media = (d.getNota1() + d.getNota2()) / 2.0;
-        somaPonderada += media * static_cast<double>(creditos);
-        somaCreditos  += creditos;
-    }
+// ---------- privados ----------
 
-    if (somaCreditos == 0) {
-        LOG_DBG("calculateCR: somaCreditos=0, retorno 0.0")
-        return 0.0;
+// Com crMtx travado (calculateCR) ou dentro de uma gravacao, que no
+// SynchronizedHistoricoService ja e exclusiva
+bool HistoricoService::somasEmDia() const
+{
+    if (!somasValidas)
+        return false;
+    const std::uint64_t rev = repo.revision();
+    return rev != 0 && rev == somasRevisao;
+}
+
+void HistoricoService::reconstruirSomas() const
+{
+    // revisao lida antes da lista: uma gravacao de fora no meio do caminho
+    // so faz a proxima consulta refazer as somas de novo
+    const std::uint64_t rev = repo.revision();
+    SomasCR novas;
+    for (const auto& d : repo.list())
+        acumular(novas, d, +1);
+    somas = novas;
+    somasValidas = true;
+    somasRevisao = rev;
+    LOG_DBG("reconstruirSomas: disciplinas=", somas.disciplinas, " revisao=", rev)
+}
+
+void HistoricoService::ajustarSomas(bool estavamEmDia, const Disciplina* removida, const Disciplina* incluida)
+{
+    std::lock_guard<std::mutex> lock(crMtx);
+    if (!estavamEmDia) {
+        somasValidas = false;
+        return;
     }
-    double cr = somaPonderada / static_cast<double>(somaCreditos);
-    LOG_INF("calculateCR: ok, CR=", cr, " (disciplinas=", disciplinas.size(), ", somaCreditos=", somaCreditos, ")")
-    return cr;
+    if (removida) acumular(somas, *removida, -1);
+    if (incluida) acumular(somas, *incluida, +1);
+    somasRevisao = repo.revision();
 }
 
-// ---------- privados ----------
+void HistoricoService::acumular(SomasCR& s, const Disciplina& d, int sinal)
+{
+    const int creditos = d.getCreditos();
+    if (creditos <= 0)
+        return; // ignora registros com creditos invalidos
+
+    const double media = (d.getNota1() + d.getNota2()) / 2.0;
+    s.ponderada += sinal * media * static_cast<double>(creditos);
+    s.creditos  += sinal * creditos;
+    s.disciplinas = sinal > 0 ? s.disciplinas + 1 : s.disciplinas - 1;
+    // sem disciplinas, zera de fato (nao acumula erro de arredondamento)
+    if (s.creditos == 0)
+        s.ponderada = 0.0;
+}
+
+void HistoricoService::notificar(DisciplinaEvento::Tipo tipo, int id)
+{
+    if (!listener)
+        return;
+
+    DisciplinaEvento e;
+    e.tipo = tipo;
+    e.id   = id;
+    try {
+        // nos repositorios posicionais a remocao move o ultimo registro
+        // para o id removido: isso nao e um delta simples
+        if (tipo == DisciplinaEvento::Tipo::Remove && repo.exist(id))
+            e.tipo = DisciplinaEvento::Tipo::Reset;
+        if (e.tipo == DisciplinaEvento::Tipo::Insert || e.tipo == DisciplinaEvento::Tipo::Update)
+            e.disciplina = get(id);
+        e.cr = calculateCR();
+        listener(e);
+    }
+    catch (const std::exception& ex) {
+        // a alteracao ja foi gravada; falha ao notificar nao a desfaz
+        LOG_ERR("notificar: falha ao notificar alteracao id=", id, ": ", ex.what())
+    }
+}
 
 int HistoricoService::anoCorrente()
 {
@@ -1,6 +1,8 @@
 #ifndef  _HISTORICO_SERVICE_HPP_
 #define _HISTORICO_SERVICE_HPP_
 
+#include <cstdint>
+#include <mutex>
 #include "ILogger.hpp"
 #include "IHistoricoService.hpp"
 #include "IDisciplinaRepository.hpp"
@@ -17,23 +19,52 @@
 //
 // Em violação de regra -> BusinessError.
 // Erros de infra/conversão do repositório são propagados.
+//
+// CR: as somas (media * creditos e creditos) ficam em memória e são
+// ajustadas em O(1) a cada insert/update/remove feito por este service.
+// Só são refeitas com list() quando repo.revision() indica que os dados
+// mudaram por fora (ou depois de um lote).
 
 class HistoricoService final : public IHistoricoService {
     private:
         IDisciplinaRepository& repo;
         ILogger& log;
+        ChangeListener listener;
+
+        struct SomasCR {
+            double ponderada = 0.0;    // soma de media * creditos
+            long long creditos = 0;
+            std::size_t disciplinas = 0;
+        };
+        // calculateCR é const e pode ser chamado por várias threads ao
+        // mesmo tempo (leitores no SynchronizedHistoricoService)
+        mutable std::mutex crMtx;
+        mutable SomasCR somas;
+        mutable bool somasValidas = false;
+        mutable std::uint64_t somasRevisao = 0;
+
         int anoCorrente();
         std::string trim(const std::string& s);
         void validarDisciplina(const Disciplina& d);
+        void notificar(DisciplinaEvento::Tipo tipo, int id);
+        bool somasEmDia() const;
+        void reconstruirSomas() const;
+        // depois de gravar: aplica o delta se as somas estavam em dia antes
+        void ajustarSomas(bool estavamEmDia, const Disciplina* removida, const Disciplina* incluida);
+        static void acumular(SomasCR& s, const Disciplina& d, int sinal);
     public:
         explicit HistoricoService(IDisciplinaRepository& aRepo, ILogger& aLog);
 
         int insert(const Disciplina& disciplina) override;
         void update(int id, const Disciplina& disciplina) override;
         void remove(int id) override;
+        std::vector<int> applyBatch(const std::vector<DisciplinaOperacao>& ops) override;
         Disciplina get(int id) const override;
         std::vector<Disciplina> list() const override;
+        DisciplinaPage query(const DisciplinaQuery& q) const override;
         double calculateCR() const override;
+        DisciplinaEstatisticas statistics() const override;
+        void setChangeListener(ChangeListener listener) override;
 };
 
 #endif
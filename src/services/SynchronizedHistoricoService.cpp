@@ -0,0 +1,68 @@
+#include "SynchronizedHistoricoService.hpp"
+
+#include <mutex>
+
+SynchronizedHistoricoService::SynchronizedHistoricoService(IHistoricoService& aInner)
+    : inner(aInner)
+{
+}
+
+int SynchronizedHistoricoService::insert(const Disciplina& disciplina)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    return inner.insert(disciplina);
+}
+
+void SynchronizedHistoricoService::update(int id, const Disciplina& disciplina)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    inner.update(id, disciplina);
+}
+
+void SynchronizedHistoricoService::remove(int id)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    inner.remove(id);
+}
+
+std::vector<int> SynchronizedHistoricoService::applyBatch(const std::vector<DisciplinaOperacao>& ops)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    return inner.applyBatch(ops);
+}
+
+Disciplina SynchronizedHistoricoService::get(int id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return inner.get(id);
+}
+
+std::vector<Disciplina> SynchronizedHistoricoService::list() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return inner.list();
+}
+
+DisciplinaPage SynchronizedHistoricoService::query(const DisciplinaQuery& q) const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return inner.query(q);
+}
+
+double SynchronizedHistoricoService::calculateCR() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return inner.calculateCR();
+}
+
+DisciplinaEstatisticas SynchronizedHistoricoService::statistics() const
+{
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return inner.statistics();
+}
+
+void SynchronizedHistoricoService::setChangeListener(ChangeListener listener)
+{
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    inner.setChangeListener(std::move(listener));
+}
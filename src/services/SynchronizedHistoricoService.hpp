@@ -0,0 +1,37 @@
+#ifndef _SYNCHRONIZED_HISTORICO_SERVICE_HPP_
+#define _SYNCHRONIZED_HISTORICO_SERVICE_HPP_
+
+#include <shared_mutex>
+
+#include "IHistoricoService.hpp"
+
+// Decorator thread-safe para IHistoricoService.
+//
+// Usado por UIs que atendem várias requisições em paralelo (ex.: UIWeb):
+// - consultas (get, list, query, calculateCR) usam lock compartilhado e podem
+//   rodar ao mesmo tempo;
+// - alterações (insert, update, remove, applyBatch) usam lock exclusivo, garantindo
+//   que a checagem de unicidade e a gravação aconteçam sem interferência.
+//
+// Não altera regras de negócio: apenas delega para o service decorado.
+
+class SynchronizedHistoricoService final : public IHistoricoService {
+    private:
+        IHistoricoService& inner;
+        mutable std::shared_mutex mtx;
+    public:
+        explicit SynchronizedHistoricoService(IHistoricoService& aInner);
+
+        int insert(const Disciplina& disciplina) override;
+        void update(int id, const Disciplina& disciplina) override;
+        void remove(int id) override;
+        std::vector<int> applyBatch(const std::vector<DisciplinaOperacao>& ops) override;
+        Disciplina get(int id) const override;
+        std::vector<Disciplina> list() const override;
+        DisciplinaPage query(const DisciplinaQuery& q) const override;
+        double calculateCR() const override;
+        DisciplinaEstatisticas statistics() const override;
+        void setChangeListener(ChangeListener listener) override;
+};
+
+#endif
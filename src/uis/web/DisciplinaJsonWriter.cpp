@@ -0,0 +1,97 @@
+#include "DisciplinaJsonWriter.hpp"
+
+#include <charconv>
+#include <string_view>
+#include <cmath>
+
+namespace DisciplinaJsonWriter {
+
+void append(std::string& out, const Disciplina& d)
+{
+    // mesma ordem de chaves do nlohmann::json (std::map)
+    out += "{\"ano\":";        appendNumber(out, d.getAno());
+    out += ",\"creditos\":";   appendNumber(out, d.getCreditos());
+    out += ",\"id\":";         appendNumber(out, d.getId());
+    out += ",\"matricula\":";  appendString(out, d.getMatricula());
+    out += ",\"media\":";      appendNumber(out, d.getMedia());
+    out += ",\"nome\":";       appendString(out, d.getNome());
+    out += ",\"nota1\":";      appendNumber(out, d.getNota1());
+    out += ",\"nota2\":";      appendNumber(out, d.getNota2());
+    out += ",\"semestre\":";   appendNumber(out, d.getSemestre());
+    out += '}';
+}
+
+void appendString(std::string& out, const std::string& s)
+{
+    static const char* hex = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+void appendNumber(std::string& out, int v)
+{
+    char buf[16];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+void appendNumber(std::string& out, double v)
+{
+    if (!std::isfinite(v)) {
+        out += "null";
+        return;
+    }
+    // menor representação que volta ao mesmo double; "6" vira "6.0" como no nlohmann
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    std::string_view txt(buf, (std::size_t)(res.ptr - buf));
+    out += txt;
+    if (txt.find_first_of(".e") == std::string_view::npos)
+        out += ".0";
+}
+
+}
+
+DisciplinaJsonArrayStream::DisciplinaJsonArrayStream(std::vector<Disciplina> aItems,
+                                                     std::size_t aChunkSize)
+    : items(std::move(aItems)), chunkSize(aChunkSize)
+{
+}
+
+bool DisciplinaJsonArrayStream::next(std::string& out)
+{
+    const std::size_t limit = out.size() + chunkSize;
+    if (!started) {
+        out += '[';
+        started = true;
+    }
+    while (pos < items.size() && out.size() < limit) {
+        if (pos > 0) out += ',';
+        DisciplinaJsonWriter::append(out, items[pos++]);
+    }
+    if (pos < items.size())
+        return true;
+    out += ']';
+    items.clear();
+    items.shrink_to_fit();
+    return false;
+}
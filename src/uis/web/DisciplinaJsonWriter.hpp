@@ -0,0 +1,40 @@
+#ifndef _DISCIPLINA_JSON_WRITER_HPP_
+#define _DISCIPLINA_JSON_WRITER_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Disciplina.hpp"
+
+// Serialização de Disciplina em JSON direto num std::string de saída,
+// sem montar o DOM do nlohmann::json. Gera o mesmo texto que
+// disciplinaToJson(d).dump() (chaves em ordem alfabética).
+//
+// DisciplinaJsonArrayStream escreve um array em pedaços de ~chunkSize
+// bytes, reaproveitando o buffer do chamador: usado nas respostas
+// "Transfer-Encoding: chunked" da UIWeb.
+
+namespace DisciplinaJsonWriter {
+    void append(std::string& out, const Disciplina& d);
+    void appendString(std::string& out, const std::string& s);
+    void appendNumber(std::string& out, int v);
+    void appendNumber(std::string& out, double v);
+}
+
+class DisciplinaJsonArrayStream {
+    public:
+        DisciplinaJsonArrayStream(std::vector<Disciplina> items, std::size_t chunkSize);
+
+        // Acrescenta o próximo pedaço do array em 'out'.
+        // Retorna false quando o array terminou (o "]" já foi escrito).
+        bool next(std::string& out);
+
+    private:
+        std::vector<Disciplina> items;
+        std::size_t chunkSize;
+        std::size_t pos = 0;
+        bool started = false;
+};
+
+#endif
@@ -0,0 +1,294 @@
+#include "HttpParser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+    // tchar da RFC 9110 (nomes de método e de cabeçalho)
+    bool isToken(unsigned char c)
+    {
+        if (c >= 'a' && c <= 'z') return true;
+        if (c >= 'A' && c <= 'Z') return true;
+        if (c >= '0' && c <= '9') return true;
+        return std::strchr("!#$%&'*+-.^_`|~", c) != nullptr && c != 0;
+    }
+
+    char lowerAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+
+    bool equalsNoCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (lowerAscii(a[i]) != lowerAscii(b[i])) return false;
+        return true;
+    }
+
+    std::string_view trimOws(std::string_view s)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back()  == ' ' || s.back()  == '\t')) s.remove_suffix(1);
+        return s;
+    }
+}
+
+HttpParser::HttpParser(std::size_t aMaxHeader, std::size_t aMaxBody)
+    : maxHeader(aMaxHeader), maxBody(aMaxBody)
+{
+}
+
+char* HttpParser::writePtr(std::size_t& room)
+{
+    if (end == buf.size()) {
+        if (begin > 0) {
+            // compacta: os offsets do parse são relativos a 'begin'
+            std::memmove(buf.data(), buf.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        else {
+            const std::size_t limit = maxHeader + maxBody;
+            if (buf.size() < limit)
+                buf.resize(std::min(limit, std::max(INITIAL_SIZE, buf.size() * 2)));
+        }
+    }
+    room = buf.size() - end;
+    return buf.data() + end;
+}
+
+void HttpParser::commit(std::size_t n)
+{
+    end += n;
+}
+
+HttpParser::Status HttpParser::parse()
+{
+    if (state == State::Done)  return Status::Complete;
+    if (state == State::Error) return Status::Error;
+
+    const char* p = buf.data() + begin;
+    const std::size_t avail = end - begin;
+
+    for (; scan < avail && state < State::Body; ++scan) {
+        const unsigned char c = (unsigned char)p[scan];
+        switch (state) {
+            case State::Method:
+                if (isToken(c)) break;
+                // linhas vazias antes da requisição são ignoradas (RFC 9112 2.2)
+                if ((c == '\r' || c == '\n') && method.b == scan) { method.b = scan + 1; break; }
+                if (c != ' ' || method.b == scan) return fail(400);
+                method.e = scan;
+                path.b = scan + 1;
+                state = State::Target;
+                break;
+
+            case State::Target:
+                if (c > 0x20 && c < 0x7f) break;
+                if (c != ' ' || path.b == scan) return fail(400);
+                path.e = scan;
+                version.b = scan + 1;
+                state = State::Version;
+                break;
+
+            case State::Version:
+                if (c == '\r' || c == '\n') {
+                    version.e = scan;
+                    if (!onRequestLine()) return Status::Error;
+                    state = c == '\r' ? State::RequestLineLF : State::HeaderLineStart;
+                }
+                else if (scan - version.b >= 8) {
+                    return fail(400);
+                }
+                break;
+
+            case State::RequestLineLF:
+            case State::HeaderLF:
+            case State::HeadersEndLF:
+                if (c != '\n') return fail(400);
+                if (state == State::HeaderLF && !onHeader()) return Status::Error;
+                if (state == State::HeadersEndLF) { headerLen = scan + 1; state = State::Body; }
+                else state = State::HeaderLineStart;
+                break;
+
+            case State::HeaderLineStart:
+                if (c == '\r') { state = State::HeadersEndLF; break; }
+                if (c == '\n') { headerLen = scan + 1; state = State::Body; break; }
+                // continuação de linha (obs-fold) não é aceita
+                if (!isToken(c)) return fail(400);
+                name.b = scan;
+                state = State::HeaderName;
+                break;
+
+            case State::HeaderName:
+                if (isToken(c)) break;
+                if (c != ':') return fail(400);
+                name.e = scan;
+                value.b = scan + 1;
+                state = State::HeaderValue;
+                break;
+
+            case State::HeaderValue:
+                if (c == '\r' || c == '\n') {
+                    value.e = scan;
+                    if (c == '\r') { state = State::HeaderLF; break; }
+                    if (!onHeader()) return Status::Error;
+                    state = State::HeaderLineStart;
+                    break;
+                }
+                if (c < 0x20 && c != '\t') return fail(400);
+                if (c == 0x7f) return fail(400);
+                break;
+
+            default:
+                break;
+        }
+        if (scan >= maxHeader) return fail(431);
+    }
+
+    if (state < State::Body) {
+        if (scan >= maxHeader) return fail(431);
+        return Status::Incomplete;
+    }
+
+    if (avail - headerLen < contentLength)
+        return Status::Incomplete;
+    state = State::Done;
+    return Status::Complete;
+}
+
+bool HttpParser::onRequestLine()
+{
+    std::string_view v = view(version);
+    if (v == "HTTP/1.1")      http11 = true;
+    else if (v == "HTTP/1.0") http11 = false;
+    else { fail(v.rfind("HTTP/", 0) == 0 ? 505 : 400); return false; }
+
+    // HTTP/1.1 é persistente por padrão; HTTP/1.0 só com "Connection: keep-alive"
+    keepAlive = http11;
+    return true;
+}
+
+bool HttpParser::onHeader()
+{
+    const std::string_view n = view(name);
+    const std::string_view raw = view(value);
+    const std::string_view v = trimOws(raw);
+    // guarda o valor já sem espaços, como trecho do buffer
+    Span trimmed;
+    trimmed.b = value.b + (std::size_t)(v.data() - raw.data());
+    trimmed.e = trimmed.b + v.size();
+
+    if (equalsNoCase(n, "content-length")) {
+        std::size_t len = 0;
+        auto res = std::from_chars(v.data(), v.data() + v.size(), len);
+        if (v.empty() || res.ec != std::errc() || res.ptr != v.data() + v.size()) {
+            fail(400);
+            return false;
+        }
+        // repetido só é aceito com o mesmo valor (RFC 9112 6.3)
+        if (hasContentLength && len != contentLength) {
+            fail(400);
+            return false;
+        }
+        if (len > maxBody) {
+            fail(413);
+            return false;
+        }
+        contentLength = len;
+        hasContentLength = true;
+    }
+    else if (equalsNoCase(n, "transfer-encoding")) {
+        // corpo chunked no pedido não é suportado; ignorar abriria espaço
+        // para request smuggling
+        fail(501);
+        return false;
+    }
+    else if (equalsNoCase(n, "connection")) {
+        std::string_view rest = v;
+        while (!rest.empty()) {
+            auto comma = rest.find(',');
+            std::string_view tok = trimOws(rest.substr(0, comma));
+            if (equalsNoCase(tok, "close"))           keepAlive = false;
+            else if (equalsNoCase(tok, "keep-alive")) keepAlive = true;
+            if (comma == std::string_view::npos) break;
+            rest.remove_prefix(comma + 1);
+        }
+    }
+    else if (equalsNoCase(n, "if-none-match")) {
+        ifNoneMatch = trimmed;
+    }
+    else if (equalsNoCase(n, "accept-encoding")) {
+        acceptEncoding = trimmed;
+    }
+    return true;
+}
+
+HttpParser::Request HttpParser::request() const
+{
+    Request r;
+    r.method = view(method);
+    r.path = view(path);
+    r.body = std::string_view(buf.data() + begin + headerLen, contentLength);
+    r.ifNoneMatch = view(ifNoneMatch);
+    r.acceptEncoding = view(acceptEncoding);
+    r.keepAlive = keepAlive;
+    r.http11 = http11;
+    return r;
+}
+
+void HttpParser::next()
+{
+    if (state == State::Done)
+        begin += headerLen + contentLength;
+    else
+        begin = end;   // erro: o resto do buffer não tem como ser aproveitado
+
+    if (begin == end) {
+        begin = end = 0;
+        // não segura um buffer grande numa conexão ociosa
+        if (buf.size() > KEEP_SIZE) {
+            buf.resize(INITIAL_SIZE);
+            buf.shrink_to_fit();
+        }
+    }
+    reset();
+}
+
+const char* HttpParser::errorText() const
+{
+    switch (errStatus) {
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        case 505: return "HTTP Version Not Supported";
+        default:  return "Bad Request";
+    }
+}
+
+std::string_view HttpParser::view(const Span& s) const
+{
+    return std::string_view(buf.data() + begin + s.b, s.e - s.b);
+}
+
+HttpParser::Status HttpParser::fail(int status)
+{
+    state = State::Error;
+    errStatus = status;
+    return Status::Error;
+}
+
+void HttpParser::reset()
+{
+    scan = 0;
+    state = State::Method;
+    errStatus = 0;
+    method = path = version = name = value = ifNoneMatch = acceptEncoding = Span{};
+    headerLen = 0;
+    contentLength = 0;
+    hasContentLength = false;
+    keepAlive = false;
+    http11 = false;
+}
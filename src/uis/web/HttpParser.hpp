@@ -0,0 +1,97 @@
+#ifndef _HTTP_PARSER_HPP_
+#define _HTTP_PARSER_HPP_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Parser incremental de requisições HTTP/1.x da UIWeb.
+//
+// - O parser é dono do buffer de recepção da conexão: o recv escreve direto
+//   em writePtr() e parse() avança uma máquina de estados só sobre os bytes
+//   novos (nenhum byte é examinado duas vezes, sem find/substr/istringstream).
+// - O buffer cresce sob demanda até maxHeader + maxBody e é reaproveitado
+//   entre as requisições da conexão; bytes de requisições em pipeline ficam
+//   no buffer e são compactados para o início quando falta espaço.
+// - A requisição completa é devolvida como string_views para dentro do
+//   buffer: válidas até next() ou a próxima chamada a writePtr().
+// - Cabeçalhos acima de maxHeader (431), corpo acima de maxBody (413),
+//   Transfer-Encoding no pedido (501) e qualquer byte fora da gramática
+//   (400) encerram o parse com erro.
+
+class HttpParser {
+    public:
+        struct Request {
+            std::string_view method;
+            std::string_view path;           // request-target, com a query string
+            std::string_view body;
+            std::string_view ifNoneMatch;
+            std::string_view acceptEncoding;
+            bool keepAlive = false;          // HTTP/1.1 sem "Connection: close"
+            bool http11 = false;             // aceita Transfer-Encoding: chunked
+        };
+
+        enum class Status { Incomplete, Complete, Error };
+
+        HttpParser(std::size_t maxHeader, std::size_t maxBody);
+
+        // Espaço livre para o próximo recv (só com parse() == Incomplete).
+        // 'room' é 0 apenas se o buffer chegou ao limite.
+        char* writePtr(std::size_t& room);
+        void commit(std::size_t n);
+
+        // Avança sobre os bytes recebidos. Complete se repete até next().
+        Status parse();
+
+        // Só depois de parse() == Complete.
+        Request request() const;
+
+        // Descarta a requisição atual; bytes já recebidos da próxima ficam.
+        void next();
+
+        bool hasBufferedData() const { return end > begin; }
+
+        // status/motivo a responder quando parse() == Error
+        int errorStatus() const { return errStatus; }
+        const char* errorText() const;
+
+    private:
+        enum class State {
+            Method, Target, Version, RequestLineLF,
+            HeaderLineStart, HeaderName, HeaderValue, HeaderLF, HeadersEndLF,
+            Body, Done, Error
+        };
+
+        // trecho [b, e) relativo a 'begin' (sobrevive à compactação)
+        struct Span {
+            std::size_t b = 0, e = 0;
+        };
+
+        static constexpr std::size_t INITIAL_SIZE = 4096;
+        // buffers maiores que isto voltam ao tamanho inicial quando esvaziam
+        static constexpr std::size_t KEEP_SIZE = 64 * 1024;
+
+        std::size_t maxHeader;
+        std::size_t maxBody;
+        std::vector<char> buf;
+        std::size_t begin = 0;   // início da requisição atual em buf
+        std::size_t end = 0;     // fim dos bytes recebidos em buf
+        std::size_t scan = 0;    // próximo byte a examinar (relativo a begin)
+
+        State state = State::Method;
+        int errStatus = 0;
+        Span method, path, version, name, value, ifNoneMatch, acceptEncoding;
+        std::size_t headerLen = 0;
+        std::size_t contentLength = 0;
+        bool hasContentLength = false;
+        bool keepAlive = false;
+        bool http11 = false;
+
+        std::string_view view(const Span& s) const;
+        Status fail(int status);
+        bool onRequestLine();
+        bool onHeader();
+        void reset();
+};
+
+#endif
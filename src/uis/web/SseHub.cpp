@@ -0,0 +1,178 @@
+#include "SseHub.hpp"
+
+#ifdef _WIN32
+  #include <winsock2.h>
+#else
+  #include <sys/types.h>
+  #include <sys/socket.h>
+  #include <sys/time.h>
+  #include <unistd.h>
+  #include <fcntl.h>
+  #include <cerrno>
+#endif
+
+#ifndef MSG_NOSIGNAL
+  #define MSG_NOSIGNAL 0
+#endif
+
+SseHub::SseHub(ILogger& aLog)
+    : log(aLog)
+{
+}
+
+SseHub::~SseHub()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable())
+        worker.join();
+    for (int s : incoming)
+        closeSocket(s);
+}
+
+void SseHub::attach(int sock)
+{
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+    // no modo threads o socket chega bloqueante
+    int flags = ::fcntl(sock, F_GETFL, 0);
+    if (flags >= 0)
+        ::fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        incoming.push_back(sock);
+        ++clients_;
+        if (!worker.joinable())
+            worker = std::thread(&SseHub::run, this);
+    }
+    cv.notify_one();
+}
+
+void SseHub::publish(const std::string& event, const std::string& data)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        // sem ninguém ouvindo não há por que acumular
+        if (clients_.load() == 0)
+            return;
+        outbox += "event: ";
+        outbox += event;
+        outbox += "\ndata: ";
+        outbox += data;
+        outbox += "\n\n";
+    }
+    cv.notify_one();
+}
+
+void SseHub::run()
+{
+    static const std::string header =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-store\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "retry: 3000\n\n";
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<Client> conns;
+    auto lastSend = Clock::now();
+    for (;;) {
+        std::vector<int> fresh;
+        std::string msgs;
+        bool backlog = false;
+        for (const auto& c : conns)
+            backlog = backlog || c.pos < c.pending.size();
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            // com fila parada só espera o intervalo de nova tentativa
+            cv.wait_for(lock, backlog ? Clock::duration(RETRY_INTERVAL) : Clock::duration(HEARTBEAT), [&]{
+                return stopping || !incoming.empty() || !outbox.empty();
+            });
+            if (stopping)
+                break;
+            fresh.swap(incoming);
+            msgs.swap(outbox);
+        }
+        const auto now = Clock::now();
+
+        for (int s : fresh) {
+            Client c;
+            c.sock = s;
+            c.pending = header;
+            c.progress = now;
+            conns.push_back(std::move(c));
+        }
+        if (!fresh.empty())
+            LOG_DBG("SseHub: clientes=", conns.size());
+
+        // nada por HEARTBEAT: o ping mantém proxies abertos e acha quem sumiu
+        if (msgs.empty() && now - lastSend >= HEARTBEAT)
+            msgs = ": ping\n\n";
+        if (!msgs.empty())
+            lastSend = now;
+
+        for (size_t i = 0; i < conns.size(); ) {
+            Client& c = conns[i];
+            if (!msgs.empty()) {
+                if (c.pos == c.pending.size()) {
+                    c.pending.clear();
+                    c.pos = 0;
+                    c.progress = now;
+                }
+                c.pending += msgs;
+            }
+            const bool stalled = c.pos < c.pending.size() && now - c.progress > SEND_TIMEOUT;
+            if (!stalled && c.pending.size() - c.pos <= MAX_PENDING && flush(c, now)) {
+                ++i;
+                continue;
+            }
+            closeSocket(c.sock);
+            conns[i] = std::move(conns.back());
+            conns.pop_back();
+            --clients_;
+            LOG_DBG("SseHub: clientes=", conns.size());
+        }
+    }
+
+    for (const auto& c : conns)
+        closeSocket(c.sock);
+    clients_ = 0;
+}
+
+bool SseHub::flush(Client& c, std::chrono::steady_clock::time_point now)
+{
+    while (c.pos < c.pending.size()) {
+#ifdef _WIN32
+        int n = ::send(c.sock, c.pending.data() + c.pos, (int)(c.pending.size() - c.pos), 0);
+        if (n < 0 && WSAGetLastError() == WSAEWOULDBLOCK) return true;
+        if (n <= 0) return false;
+#else
+        ssize_t n = ::send(c.sock, c.pending.data() + c.pos, c.pending.size() - c.pos, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true; // socket cheio
+        if (n <= 0) return false;   // erro ou cliente fechou
+#endif
+        c.pos += (size_t)n;
+        c.progress = now;
+    }
+    c.pending.clear();
+    c.pos = 0;
+    return true;
+}
+
+void SseHub::closeSocket(int sock)
+{
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    ::close(sock);
+#endif
+}
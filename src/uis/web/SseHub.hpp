@@ -0,0 +1,78 @@
+#ifndef _SSE_HUB_HPP_
+#define _SSE_HUB_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ILogger.hpp"
+
+// Conexões Server-Sent Events (GET /api/events) da UIWeb.
+//
+// Uma conexão SSE fica aberta indefinidamente; para não prender uma thread
+// do pool (modo threads) nem o laço epoll, o socket é entregue ao hub, que
+// tem uma thread própria para enviar os eventos a todos os clientes.
+//
+// - publish() só enfileira (é chamado dentro do lock do service). O
+//   cliente conta como inscrito desde attach(), antes do cabeçalho sair:
+//   nada publicado depois de attach() se perde.
+// - Os sockets ficam não bloqueantes, cada um com a sua fila: um cliente
+//   lento não atrasa os outros. O que não coube no socket é tentado de
+//   novo a cada RETRY_INTERVAL; quem não lê nada por SEND_TIMEOUT, ou
+//   acumula mais de MAX_PENDING bytes, é desconectado (o EventSource
+//   reconecta sozinho).
+// - Sem eventos, um comentário é enviado a cada HEARTBEAT, o que mantém
+//   proxies abertos e detecta clientes que sumiram.
+
+class SseHub {
+    public:
+        explicit SseHub(ILogger& aLog);
+        ~SseHub();
+
+        SseHub(const SseHub&) = delete;
+        SseHub& operator=(const SseHub&) = delete;
+
+        // Assume o socket: envia o cabeçalho da resposta e passa a
+        // transmitir os eventos. O chamador não deve mais usá-lo.
+        void attach(int sock);
+
+        // Enfileira um evento ("event: <event>\ndata: <data>\n\n") para
+        // todos os clientes conectados. 'data' não pode ter quebra de linha.
+        void publish(const std::string& event, const std::string& data);
+
+        std::size_t clientCount() const { return clients_.load(); }
+
+    private:
+        static constexpr std::chrono::seconds HEARTBEAT{15};
+        static constexpr std::chrono::seconds SEND_TIMEOUT{2};
+        static constexpr std::chrono::milliseconds RETRY_INTERVAL{50};
+        static constexpr std::size_t MAX_PENDING = 1 << 20;
+
+        struct Client {
+            int sock = -1;
+            std::string pending;     // ainda não aceito pelo socket
+            std::size_t pos = 0;     // já enviado de 'pending'
+            std::chrono::steady_clock::time_point progress; // último envio
+        };
+
+        ILogger& log;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<int> incoming;   // sockets novos, ainda sem cabeçalho
+        std::string outbox;          // eventos já formatados, não enviados
+        bool stopping = false;
+        // inscritos: conta de attach() até o socket fechar (em run)
+        std::atomic<std::size_t> clients_{0};
+        std::thread worker;
+
+        void run();
+        // Envia o que o socket aceitar sem bloquear; false = conexão perdida.
+        static bool flush(Client& c, std::chrono::steady_clock::time_point now);
+        static void closeSocket(int sock);
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "StaticFileCache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+
+#ifdef UIWEB_HAVE_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+StaticFileCache::StaticFileCache(const std::string& aDocroot, bool aRefresh,
+                                 std::uintmax_t aMaxFileSize)
+    : docroot(aDocroot), refresh(aRefresh), maxFileSize(aMaxFileSize)
+{
+}
+
+std::size_t StaticFileCache::load()
+{
+    std::map<std::string, std::shared_ptr<const Entry>> loaded;
+
+    std::error_code ec;
+    fs::path root(docroot);
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec))
+            continue;
+        std::string rel = fs::relative(it->path(), root, ec).generic_string();
+        if (ec)
+            continue;
+        std::string path = "/" + rel;
+        if (auto e = loadEntry(path, it->path()))
+            loaded[path] = e;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    entries.swap(loaded);
+    return entries.size();
+}
+
+std::shared_ptr<const StaticFileCache::Entry> StaticFileCache::find(const std::string& path)
+{
+    std::shared_ptr<const Entry> e;
+    {
+        std::shared_lock<std::shared_mutex> lock(mtx);
+        auto it = entries.find(path);
+        if (it != entries.end())
+            e = it->second;
+    }
+    if (!refresh)
+        return e;
+
+    // modo desenvolvimento: confere se o arquivo mudou (ou surgiu) no disco
+    fs::path full = fs::path(docroot) / fs::path(path.substr(1));
+    std::error_code ec;
+    auto mtime = fs::last_write_time(full, ec);
+    if (ec) {
+        if (e) {
+            std::unique_lock<std::shared_mutex> lock(mtx);
+            entries.erase(path);
+        }
+        return nullptr;
+    }
+    auto size = fs::file_size(full, ec);
+    if (e && !ec && e->mtime == mtime && e->size == size)
+        return e;
+
+    auto fresh = loadEntry(path, full);
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    if (fresh)
+        entries[path] = fresh;
+    else
+        entries.erase(path);
+    return fresh;
+}
+
+std::shared_ptr<const StaticFileCache::Entry>
+StaticFileCache::loadEntry(const std::string& path, const fs::path& full) const
+{
+    std::error_code ec;
+    auto mtime = fs::last_write_time(full, ec);
+    if (ec)
+        return nullptr;
+    auto size = fs::file_size(full, ec);
+    if (ec)
+        return nullptr;
+
+    auto e = std::make_shared<Entry>();
+    e->size        = size;
+    e->mtime       = mtime;
+    e->fullPath    = full.string();
+    e->contentType = guessMime(path);
+
+    if (size > maxFileSize) {
+        // arquivo grande: fica no disco; ETag pelos metadados
+        std::ostringstream tag;
+        tag << '"' << std::hex << size << '-'
+            << static_cast<unsigned long long>(mtime.time_since_epoch().count()) << '"';
+        e->etag = tag.str();
+        return e;
+    }
+
+    std::ifstream f(full, std::ios::binary);
+    if (!f)
+        return nullptr;
+    auto body = std::make_shared<std::string>();
+    body->resize(static_cast<std::size_t>(size));
+    if (size > 0 && !f.read(&(*body)[0], static_cast<std::streamsize>(size)))
+        return nullptr;
+
+    const std::string hash = hashHex(*body);
+    e->etag        = "\"" + hash + "\"";
+    e->gzipEtag    = "\"" + hash + "-gz\"";
+    e->deflateEtag = "\"" + hash + "-df\"";
+
+    // só guarda a variante comprimida se ela for menor que o original
+    std::string gz = compress(*body, true);
+    if (!gz.empty() && gz.size() < body->size())
+        e->gzipBody = std::make_shared<const std::string>(std::move(gz));
+    std::string df = compress(*body, false);
+    if (!df.empty() && df.size() < body->size())
+        e->deflateBody = std::make_shared<const std::string>(std::move(df));
+
+    e->body = std::move(body);
+    return e;
+}
+
+std::string StaticFileCache::guessMime(const std::string& path)
+{
+    auto dot = path.find_last_of('.');
+    std::string ext = (dot==std::string::npos) ? "" : path.substr(dot+1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext=="html") return "text/html; charset=utf-8";
+    if (ext=="js")   return "application/javascript; charset=utf-8";
+    if (ext=="css")  return "text/css; charset=utf-8";
+    if (ext=="png")  return "image/png";
+    if (ext=="jpg" || ext=="jpeg") return "image/jpeg";
+    if (ext=="ico")  return "image/x-icon";
+    if (ext=="json") return "application/json; charset=utf-8";
+    return "text/plain; charset=utf-8";
+}
+
+// FNV-1a 64 bits: suficiente para ETag (não é uso criptográfico)
+std::string StaticFileCache::hashHex(const std::string& data)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    static const char* hex = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        out[i] = hex[h & 0xF];
+        h >>= 4;
+    }
+    return out;
+}
+
+std::string StaticFileCache::compress(const std::string& data, bool gzip)
+{
+#ifdef UIWEB_HAVE_ZLIB
+    z_stream zs{};
+    // windowBits 15 = formato zlib ("deflate" do HTTP); +16 = gzip
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, gzip ? 15 + 16 : 15,
+                     8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return {};
+
+    std::string out;
+    out.resize(deflateBound(&zs, (uLong)data.size()));
+    zs.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in  = (uInt)data.size();
+    zs.next_out  = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = (uInt)out.size();
+
+    int rc = deflate(&zs, Z_FINISH);
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END)
+        return {};
+    out.resize(zs.total_out);
+    return out;
+#else
+    (void)data; (void)gzip;
+    return {};
+#endif
+}
@@ -0,0 +1,64 @@
+#ifndef _STATIC_FILE_CACHE_HPP_
+#define _STATIC_FILE_CACHE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+
+// Cache em memória dos arquivos estáticos servidos pela UIWeb.
+//
+// - Todo o docroot é carregado uma vez (load); cada entrada é imutável e
+//   compartilhada entre as threads via shared_ptr (o corpo também, para a
+//   resposta não precisar copiá-lo).
+// - Cada entrada tem um ETag derivado do hash do conteúdo e, quando há
+//   zlib disponível (UIWEB_HAVE_ZLIB), variantes gzip/deflate já prontas,
+//   cada uma com o seu ETag (outra codificação é outra representação).
+// - Arquivos maiores que maxFileSize não ficam em memória: a entrada guarda
+//   só os metadados (ETag por tamanho+mtime) e o corpo é enviado do disco.
+// - Com refresh ligado (desenvolvimento), find() compara o mtime/tamanho
+//   do arquivo e recarrega só a entrada que mudou.
+
+class StaticFileCache {
+    public:
+        struct Entry {
+            std::string contentType;
+            std::string etag;         // já entre aspas, pronto para o header
+            std::string gzipEtag;     // "<hash>-gz"
+            std::string deflateEtag;  // "<hash>-df"
+            std::shared_ptr<const std::string> body;        // nullptr: servir do disco
+            std::shared_ptr<const std::string> gzipBody;    // nullptr se não houver/compensar
+            std::shared_ptr<const std::string> deflateBody; // idem
+            std::string fullPath;
+            std::filesystem::file_time_type mtime;
+            std::uintmax_t size = 0;
+        };
+
+        StaticFileCache(const std::string& docroot, bool refresh, std::uintmax_t maxFileSize);
+
+        // Carrega (ou recarrega) todos os arquivos do docroot.
+        // Retorna a quantidade de arquivos em cache.
+        std::size_t load();
+
+        // path no formato da URL ("/app.js"). Retorna nullptr se não existir.
+        std::shared_ptr<const Entry> find(const std::string& path);
+
+        static std::string guessMime(const std::string& path);
+
+    private:
+        std::string docroot;
+        bool refresh;
+        std::uintmax_t maxFileSize;
+        std::map<std::string, std::shared_ptr<const Entry>> entries;
+        std::shared_mutex mtx;
+
+        std::shared_ptr<const Entry> loadEntry(const std::string& path,
+                                               const std::filesystem::path& full) const;
+
+        static std::string hashHex(const std::string& data);
+        static std::string compress(const std::string& data, bool gzip);
+};
+
+#endif
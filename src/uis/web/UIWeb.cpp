@@ -3,6 +3,8 @@
 #include "IHistoricoService.hpp"
 #include "Disciplina.hpp"
 #include "Errors.hpp"
+#include "ThreadPool.hpp"
+#include "DisciplinaJsonWriter.hpp"
 #include "json.hpp"
 
 #include <cstring>
@@ -11,6 +13,10 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <chrono>
+#include <functional>
 
 
 #ifdef _WIN32
@@ -24,27 +30,25 @@
   #include <netinet/in.h>
   #include <arpa/inet.h>
   #include <unistd.h>
+  #include <fcntl.h>
+  #include <csignal>
+  #include <cerrno>
+  #include <sys/stat.h>
+  #include <sys/uio.h>
   #define SOCKET int
   #define INVALID_SOCKET (-1)
   #define CLOSESOCK ::close
 #endif
 
+#ifdef __linux__
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <sys/sendfile.h>
+#endif
+
 using Json = nlohmann::json;
 
-// --- helpers JSON <-> Disciplina (ajuste campos conforme sua classe) ---
-static Json disciplinaToJson(const Disciplina& d){
-    Json j;
-    j["id"]        = d.getId();
-    j["matricula"] = d.getMatricula();
-    j["nome"]      = d.getNome();
-    j["creditos"]  = d.getCreditos();
-    j["ano"]       = d.getAno();
-    j["semestre"]  = d.getSemestre();
-    j["nota1"]     = d.getNota1();
-    j["nota2"]     = d.getNota2();
-    j["media"]     = d.getMedia();
-    return j;
-}
+// --- helpers JSON -> Disciplina (a saída usa DisciplinaJsonWriter) ---
 static Disciplina disciplinaFromJson(const Json& j){
     Disciplina d;
     d.setMatricula(j.at("matricula").get<std::string>());
@@ -57,22 +61,136 @@ static Disciplina disciplinaFromJson(const Json& j){
     return d;
 }
 
+// item de POST /api/disciplinas/batch:
+//   {"op":"insert","disciplina":{...}} | {"op":"update","id":N,"disciplina":{...}} | {"op":"remove","id":N}
+static DisciplinaOperacao operacaoFromJson(const Json& j, size_t idx){
+    const std::string onde = "Operacao " + std::to_string(idx + 1) + ": ";
+    try {
+        DisciplinaOperacao op;
+        const std::string tipo = j.at("op").get<std::string>();
+        if (tipo == "insert") {
+            op.tipo = DisciplinaOperacao::Tipo::Insert;
+            op.disciplina = disciplinaFromJson(j.at("disciplina"));
+        } else if (tipo == "update") {
+            op.tipo = DisciplinaOperacao::Tipo::Update;
+            op.id = j.at("id").get<int>();
+            op.disciplina = disciplinaFromJson(j.at("disciplina"));
+        } else if (tipo == "remove") {
+            op.tipo = DisciplinaOperacao::Tipo::Remove;
+            op.id = j.at("id").get<int>();
+        } else {
+            throw BusinessError(onde + "op invalida '" + tipo + "' (use insert, update ou remove).");
+        }
+        return op;
+    }
+    catch (const Json::exception& e) {
+        throw BusinessError(onde + "formato invalido (" + e.what() + ")");
+    }
+}
+
+// --- GET /api/estatisticas ---
+static Json grupoToJson(const EstatisticasGrupo& g){
+    Json j;
+    j["disciplinas"] = g.disciplinas;
+    j["creditos"] = g.creditos;
+    j["cr"] = g.cr();
+    j["mediaSimples"] = g.mediaSimples();
+    if (g.disciplinas > 0) {
+        j["mediaMin"] = g.mediaMin;
+        j["mediaMax"] = g.mediaMax;
+    }
+    j["distribuicao"] = g.distribuicao;
+    return j;
+}
+
+static Json estatisticasToJson(const DisciplinaEstatisticas& e){
+    Json periodos = Json::array();
+    for (const auto& p : e.periodos) {
+        Json jp;
+        jp["ano"] = p.ano;
+        jp["semestre"] = p.semestre;
+        jp["periodo"] = grupoToJson(p.periodo);
+        jp["acumulado"] = grupoToJson(p.acumulado);
+        periodos.push_back(std::move(jp));
+    }
+    Json j;
+    j["geral"] = grupoToJson(e.geral);
+    j["periodos"] = std::move(periodos);
+    return j;
+}
+
 // ----------------------------------------------------------------------
 
+// limites de uma requisição: linha de requisição + cabeçalhos, e corpo
+static const size_t MAX_HEADER_SIZE = 16 * 1024;
+static const size_t MAX_BODY_SIZE = 1024 * 1024;
+
+// tamanho aproximado de cada pedaço das respostas chunked
+static const size_t STREAM_CHUNK_SIZE = 16 * 1024;
+
 UIWeb::UIWeb(IHistoricoService& s, ILogger& lg, const Configuracao& conf)
-    : svc_(s), log(lg), port_(conf.getWebPort()), docroot_(std::move(conf.getWebPathRoot())) {
+    : svc_(s), log(lg), port_(conf.getWebPort()), threads_(conf.getWebThreads()),
+      ioMode_(conf.getWebIoMode()), keepAliveTimeout_(conf.getWebKeepAliveTimeout()),
+      keepAliveMax_(conf.getWebKeepAliveMax()), docroot_(std::move(conf.getWebPathRoot())),
+      cache_(docroot_, conf.isWebCacheRefresh(), (std::uintmax_t)conf.getWebCacheMaxFile()),
+      sse_(lg) {
+    svc_.setChangeListener([this](const DisciplinaEvento& ev){ publishChange(ev); });
+    }
+
+UIWeb::~UIWeb() {
+    // o service vive mais que a UI: não pode ficar com o listener pendurado
+    svc_.setChangeListener(nullptr);
+}
+
+// Chamado pelo service (dentro do seu lock) a cada alteração.
+// data: {"cr":..,"id":..[,"disciplina":{...}]}; em "reset" o cliente recarrega a lista.
+void UIWeb::publishChange(const DisciplinaEvento& ev){
+    const char* name = "reset";
+    switch (ev.tipo) {
+        case DisciplinaEvento::Tipo::Insert: name = "insert"; break;
+        case DisciplinaEvento::Tipo::Update: name = "update"; break;
+        case DisciplinaEvento::Tipo::Remove: name = "remove"; break;
+        case DisciplinaEvento::Tipo::Reset:  name = "reset";  break;
     }
+    std::string data = "{\"cr\":";
+    DisciplinaJsonWriter::appendNumber(data, ev.cr);
+    data += ",\"id\":";
+    DisciplinaJsonWriter::appendNumber(data, ev.id);
+    if (ev.tipo == DisciplinaEvento::Tipo::Insert || ev.tipo == DisciplinaEvento::Tipo::Update) {
+        data += ",\"disciplina\":";
+        DisciplinaJsonWriter::append(data, ev.disciplina);
+    }
+    data += '}';
+    sse_.publish(name, data);
+}
+
+bool UIWeb::isEventStream(const HttpRequest& req){
+    return req.method == "GET" && req.path.compare(0, req.path.find('?'), "/api/events") == 0;
+}
 
-void UIWeb::run() { serveLoop(); }
+void UIWeb::run() {
+#ifndef _WIN32
+    // writev/sendfile em socket fechado pelo cliente: tratar como erro, não sinal
+    ::signal(SIGPIPE, SIG_IGN);
+#endif
+    std::size_t n = cache_.load();
+    LOG_INF("UIWeb: ", n, " arquivos estaticos em cache (docroot=", docroot_, ")");
+#ifdef __linux__
+    if (ioMode_ == "epoll") { serveLoopEpoll(); return; }
+#endif
+    if (ioMode_ != "threads")
+        LOG_INF("UIWeb: WEB_IO_MODE=", ioMode_, " nao suportado nesta plataforma, usando threads");
+    serveLoop();
+}
 
-void UIWeb::serveLoop(){
+int UIWeb::openListenSocket(){
 #ifdef _WIN32
     WSADATA wsa; WSAStartup(MAKEWORD(2,2), &wsa);
 #endif
     SOCKET srv = ::socket(AF_INET, SOCK_STREAM, 0);
     if (srv == INVALID_SOCKET) {
         LOG_ERR("UIWeb: socket() falhou");
-        return;
+        return -1;
     }
     int yes = 1;
 #ifdef _WIN32
@@ -92,21 +210,41 @@ void UIWeb::serveLoop(){
     if (::bind(srv, (sockaddr*)&addr, sizeof(addr)) != 0) {
         LOG_ERR("UIWeb: bind() falhou (porta em uso?)");
         CLOSESOCK(srv);
-        return;
+        return -1;
     }
-    if (::listen(srv, 1) != 0) {
+    if (::listen(srv, SOMAXCONN) != 0) {
         LOG_ERR("UIWeb: listen() falhou");
         CLOSESOCK(srv);
-        return;
+        return -1;
     }
-    LOG_INF("UIWeb ouvindo em http://127.0.0.1:", port_);
+    LOG_INF("UIWeb ouvindo em http://127.0.0.1:", port_, " (io=", ioMode_, ", threads=", threads_, ")");
+    return (int)srv;
+}
 
-    // mono-usuário: 1 conexão por vez; 1 request por conexão; fecha
+void UIWeb::serveLoop(){
+    int srv = openListenSocket();
+    if (srv < 0) return;
+
+    // a thread principal só aceita conexões; cada conexão é atendida
+    // por uma thread do pool enquanto estiver viva
+    ThreadPool pool(static_cast<std::size_t>(threads_));
     for(;;){
         SOCKET cli = ::accept(srv, nullptr, nullptr);
         if (cli == INVALID_SOCKET) continue;
-        handleClient((int)cli);
-        CLOSESOCK(cli);
+        metrics_.connectionOpened();
+        ++poolConns_;
+        pool.submit([this, cli]{
+            bool owned = true;
+            try {
+                owned = handleClient((int)cli);
+            }
+            catch (const std::exception& e) {
+                LOG_ERR("UIWeb: falha ao atender conexao: ", e.what());
+            }
+            if (owned) CLOSESOCK(cli);
+            --poolConns_;
+            metrics_.connectionClosed();
+        });
     }
 
     CLOSESOCK(srv);
@@ -115,94 +253,445 @@ void UIWeb::serveLoop(){
 #endif
 }
 
-void UIWeb::handleClient(int sock){
-    // lê até os headers (CRLFCRLF) e, se houver Content-Length, lê o body
-    std::string data; data.reserve(8192);
-    char buf[2048]; int n;
-    // leitura bloqueante básica
-    while ((n = ::recv(sock, buf, sizeof(buf), 0)) > 0) {
-        data.append(buf, buf + n);
-        if (data.find("\r\n\r\n") != std::string::npos) break;
+bool UIWeb::handleClient(int sock){
+    // o timeout de leitura faz o papel do timeout de ociosidade do keep-alive
+#ifdef _WIN32
+    DWORD tv = (DWORD)keepAliveTimeout_ * 1000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof(tv));
+#else
+    timeval tv{};
+    tv.tv_sec = keepAliveTimeout_;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+
+    HttpParser parser(MAX_HEADER_SIZE, MAX_BODY_SIZE);
+    int served = 0;
+    for(;;){
+        HttpParser::Status st;
+        // requisições em pipeline já podem estar no buffer
+        while ((st = parser.parse()) == HttpParser::Status::Incomplete) {
+            size_t room = 0;
+            char* dst = parser.writePtr(room);
+            int n = ::recv(sock, dst, (int)room, 0);
+            if (n <= 0) return true; // fechada pelo cliente ou ociosa demais
+            metrics_.addBytesIn((uint64_t)n);
+            parser.commit((size_t)n);
+        }
+        if (st == HttpParser::Status::Error) {
+            writeCounted(sock, *toWire(parseError(parser), false));
+            return true;
+        }
+        const HttpRequest req = parser.request();
+        if (isEventStream(req)) {
+            // libera a thread do pool: o hub mantém a conexão daqui em diante
+            sse_.attach(sock);
+            return false;
+        }
+        ++served;
+        // conexão ociosa prende uma thread: persistentes só enquanto as
+        // conexões no pool (esta inclusive) couberem em metade dele, para
+        // sempre sobrar thread para quem chega
+        bool keep = req.keepAlive && keepAliveTimeout_ > 0 && served < keepAliveMax_
+                 && poolConns_.load() <= threads_ / 2;
+        // socket bloqueante: writeSome só retorna quando terminou ou falhou
+        if (writeCounted(sock, *toWire(handleRequest(req), keep)) != 1 || !keep)
+            return true;
+        parser.next();
+    }
+}
+
+#ifdef __linux__
+// ----------------------------------------------------------------------
+// Modo epoll: um laço de eventos faz accept/recv/send não bloqueantes.
+// Requisições completas são processadas no pool; a resposta volta para o
+// laço por uma fila protegida por mutex e um eventfd de notificação.
+// ----------------------------------------------------------------------
+
+namespace {
+    struct EpollConn {
+        int fd = -1;
+        uint64_t seq = 0;        // distingue conexões que reutilizam o mesmo fd
+        HttpParser parser{MAX_HEADER_SIZE, MAX_BODY_SIZE};
+        std::unique_ptr<UIWeb::WireResponse> out;
+        bool busy = false;       // requisição em processamento no pool
+        bool watched = true;     // no conjunto do epoll (sai enquanto busy)
+        bool closeAfterWrite = false;
+        int served = 0;
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+    struct EpollCompletion {
+        int fd;
+        uint64_t seq;
+        std::unique_ptr<UIWeb::WireResponse> response;
+    };
+
+    bool setNonBlocking(int fd){
+        int flags = ::fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
     }
-    if (data.empty()) return;
+}
 
-    // se tiver Content-Length, completa o body
-    auto hdrEnd = data.find("\r\n\r\n");
-    std::string headers = data.substr(0, hdrEnd+4);
-    std::string body    = (hdrEnd != std::string::npos) ? data.substr(hdrEnd+4) : "";
+void UIWeb::serveLoopEpoll(){
+    int srv = openListenSocket();
+    if (srv < 0) return;
+    setNonBlocking(srv);
 
-    size_t clpos = headers.find("Content-Length:");
-    size_t need = 0;
-    if (clpos != std::string::npos) {
-        auto lineEnd = headers.find("\r\n", clpos);
-        auto val = headers.substr(clpos + 15, lineEnd - (clpos + 15));
-        need = (size_t)std::stoul(val);
+    int ep = ::epoll_create1(EPOLL_CLOEXEC);
+    int wake = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ep < 0 || wake < 0) {
+        LOG_ERR("UIWeb: epoll_create1/eventfd falhou");
+        if (ep >= 0) ::close(ep);
+        if (wake >= 0) ::close(wake);
+        ::close(srv);
+        return;
     }
-    while (body.size() < need) {
-        n = ::recv(sock, buf, sizeof(buf), 0);
-        if (n <= 0) break;
-        body.append(buf, buf + n);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = srv;
+    ::epoll_ctl(ep, EPOLL_CTL_ADD, srv, &ev);
+    ev.data.fd = wake;
+    ::epoll_ctl(ep, EPOLL_CTL_ADD, wake, &ev);
+
+    std::unordered_map<int, EpollConn> conns;
+    uint64_t nextSeq = 1;
+
+    std::mutex doneMtx;
+    std::vector<EpollCompletion> done;
+
+    ThreadPool pool(static_cast<std::size_t>(threads_));
+
+    // sem descritores livres (EMFILE/ENFILE) o socket de escuta continua
+    // legível: sai do epoll até uma conexão fechar ou no máximo 1 s, em
+    // vez de o laço girar com accept falhando
+    bool acceptPaused = false;
+    auto lastAcceptPause = std::chrono::steady_clock::now();
+    auto resumeAccept = [&]{
+        if (!acceptPaused) return;
+        epoll_event e{};
+        e.events = EPOLLIN;
+        e.data.fd = srv;
+        ::epoll_ctl(ep, EPOLL_CTL_ADD, srv, &e);
+        acceptPaused = false;
+    };
+
+    auto closeConn = [&](int fd){
+        ::epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        conns.erase(fd);
+        metrics_.connectionClosed();
+        resumeAccept();
+    };
+
+    auto watch = [&](EpollConn& c, uint32_t events){
+        epoll_event e{};
+        e.events = events | EPOLLRDHUP;
+        e.data.fd = c.fd;
+        ::epoll_ctl(ep, c.watched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, c.fd, &e);
+        c.watched = true;
+    };
+    // enquanto ocupada a conexão fica fora do epoll: HUP/ERR/RDHUP são
+    // sempre reportados e, em nível, fariam o laço girar até a resposta
+    auto unwatch = [&](EpollConn& c){
+        ::epoll_ctl(ep, EPOLL_CTL_DEL, c.fd, nullptr);
+        c.watched = false;
+    };
+
+    std::function<void(EpollConn&)> dispatch;
+
+    // tenta escrever o que falta; retorna false se a conexão foi fechada
+    auto flushOut = [&](EpollConn& c) -> bool {
+        if (c.out) {
+            int st = writeCounted(c.fd, *c.out);
+            if (st == 0) { watch(c, EPOLLOUT); return true; }
+            c.out.reset();
+            if (st < 0) { closeConn(c.fd); return false; }
+        }
+        if (c.closeAfterWrite) { closeConn(c.fd); return false; }
+        watch(c, EPOLLIN);
+        c.lastActivity = std::chrono::steady_clock::now();
+        int fd = c.fd;
+        dispatch(c); // próxima requisição do pipeline, se já chegou
+        return conns.count(fd) > 0;
+    };
+
+    // despacha a próxima requisição completa do buffer, se houver
+    dispatch = [&](EpollConn& c){
+        if (c.busy) return;
+        HttpParser::Status st = c.parser.parse();
+        if (st == HttpParser::Status::Incomplete) return;
+        if (st == HttpParser::Status::Error) {
+            c.closeAfterWrite = true;
+            c.out = toWire(parseError(c.parser), false);
+            flushOut(c);
+            return;
+        }
+        // as views apontam para o buffer da conexão, que não é tocado
+        // enquanto ela estiver ocupada (busy)
+        HttpRequest req = c.parser.request();
+        if (isEventStream(req)) {
+            // sai do epoll sem fechar: o hub mantém a conexão daqui em diante
+            int fd = c.fd;
+            ::epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+            conns.erase(fd);
+            metrics_.connectionClosed();
+            sse_.attach(fd);
+            return;
+        }
+        bool keep = req.keepAlive && keepAliveTimeout_ > 0 && ++c.served < keepAliveMax_;
+        c.closeAfterWrite = !keep;
+        c.busy = true;
+        unwatch(c); // não lê mais nada enquanto processa
+        int fd = c.fd; uint64_t seq = c.seq;
+        pool.submit([this, fd, seq, keep, req, &doneMtx, &done, wake]{
+            std::unique_ptr<WireResponse> resp;
+            try {
+                resp = toWire(handleRequest(req), keep);
+            }
+            catch (const std::exception& e) {
+                LOG_ERR("UIWeb: falha ao processar requisicao: ", e.what());
+                resp = toWire(httpResponse(500,"Internal Server Error","text/plain","erro interno"), false);
+            }
+            {
+                std::lock_guard<std::mutex> lock(doneMtx);
+                done.push_back(EpollCompletion{fd, seq, std::move(resp)});
+            }
+            uint64_t one = 1;
+            ssize_t w = ::write(wake, &one, sizeof(one));
+            (void)w;
+        });
+    };
+
+    // fecha conexões ociosas (inclusive as que nunca completam a requisição)
+    const auto idleLimit = std::chrono::seconds(keepAliveTimeout_ > 0 ? keepAliveTimeout_ : 5);
+    auto lastSweep = std::chrono::steady_clock::now();
+    auto sweepIdle = [&]{
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSweep < std::chrono::seconds(1)) return;
+        lastSweep = now;
+        std::vector<int> expired;
+        for (auto& kv : conns)
+            if (!kv.second.busy && !kv.second.out && now - kv.second.lastActivity > idleLimit)
+                expired.push_back(kv.first);
+        for (int fd : expired) closeConn(fd);
+        if (acceptPaused && now - lastAcceptPause >= std::chrono::seconds(1))
+            resumeAccept();
+    };
+
+    std::vector<epoll_event> events(256);
+    for(;;){
+        int n = ::epoll_wait(ep, events.data(), (int)events.size(), 1000);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERR("UIWeb: epoll_wait falhou");
+            break;
+        }
+        sweepIdle();
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t evs = events[i].events;
+
+            if (fd == srv) {
+                for(;;){
+                    int cli = ::accept4(srv, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (cli < 0) {
+                        if (errno == EINTR || errno == ECONNABORTED) continue;
+                        if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                            LOG_ERR("UIWeb: accept falhou (", std::strerror(errno), "), pausando novas conexoes");
+                            ::epoll_ctl(ep, EPOLL_CTL_DEL, srv, nullptr);
+                            acceptPaused = true;
+                            lastAcceptPause = std::chrono::steady_clock::now();
+                        }
+                        break;
+                    }
+                    metrics_.connectionOpened();
+                    EpollConn& c = conns[cli];
+                    c = EpollConn{};
+                    c.fd = cli;
+                    c.seq = nextSeq++;
+                    c.lastActivity = std::chrono::steady_clock::now();
+                    epoll_event e{};
+                    e.events = EPOLLIN | EPOLLRDHUP;
+                    e.data.fd = cli;
+                    ::epoll_ctl(ep, EPOLL_CTL_ADD, cli, &e);
+                }
+                continue;
+            }
+
+            if (fd == wake) {
+                uint64_t cnt;
+                while (::read(wake, &cnt, sizeof(cnt)) > 0) {}
+                std::vector<EpollCompletion> ready;
+                {
+                    std::lock_guard<std::mutex> lock(doneMtx);
+                    ready.swap(done);
+                }
+                for (auto& r : ready) {
+                    auto it = conns.find(r.fd);
+                    if (it == conns.end() || it->second.seq != r.seq) continue;
+                    EpollConn& c = it->second;
+                    c.busy = false;
+                    c.parser.next();
+                    c.out = std::move(r.response);
+                    flushOut(c);
+                }
+                continue;
+            }
+
+            auto it = conns.find(fd);
+            if (it == conns.end()) continue;
+            EpollConn& c = it->second;
+
+            if (evs & (EPOLLERR | EPOLLHUP)) {
+                if (!c.busy) closeConn(fd);
+                continue;
+            }
+
+            if (evs & EPOLLOUT) {
+                if (!flushOut(c)) continue;
+            }
+
+            // ocupada: o buffer não pode mudar até a resposta voltar do pool
+            if (c.busy) continue;
+
+            if (evs & (EPOLLIN | EPOLLRDHUP)) {
+                bool peerClosed = false;
+                for(;;){
+                    size_t room = 0;
+                    char* dst = c.parser.writePtr(room);
+                    if (room == 0) break; // buffer no limite: o parse decide
+                    ssize_t r = ::recv(fd, dst, room, 0);
+                    if (r > 0) { metrics_.addBytesIn((uint64_t)r); c.parser.commit((size_t)r); continue; }
+                    if (r == 0) peerClosed = true;
+                    else if (errno != EAGAIN && errno != EWOULDBLOCK) peerClosed = true;
+                    break;
+                }
+                if (peerClosed && !c.busy) { closeConn(fd); continue; }
+                c.lastActivity = std::chrono::steady_clock::now();
+                dispatch(c);
+            }
+        }
     }
 
-    handleRequest(data, sock);
+    ::close(wake);
+    ::close(ep);
+    ::close(srv);
 }
+#else
+void UIWeb::serveLoopEpoll(){ serveLoop(); }
+#endif
+
+// ----------------------------------------------------------------------
+// Parsing da requisição
+// ----------------------------------------------------------------------
 
-static inline std::string trim(const std::string& s){
-    size_t a=0,b=s.size();
-    while(a<b && (unsigned char)s[a]<=32) ++a;
-    while(b>a && (unsigned char)s[b-1]<=32) --b;
-    return s.substr(a,b-a);
+UIWeb::HttpResponse UIWeb::parseError(const HttpParser& parser){
+    auto r = httpResponse(parser.errorStatus(), parser.errorText(), "text/plain", parser.errorText());
+    return r;
 }
 
-void UIWeb::handleRequest(const std::string& req, int sock){
-    // request line
-    auto eol = req.find("\r\n");
-    if (eol == std::string::npos) return;
-    std::string line = req.substr(0, eol);
-    std::istringstream iss(line);
-    std::string method, path, httpver; iss >> method >> path >> httpver;
-    if (path.empty()) path = "/";
-
-    // body (já extraído em handleClient)
-    auto hdrEnd = req.find("\r\n\r\n");
-    std::string body = (hdrEnd != std::string::npos) ? req.substr(hdrEnd+4) : "";
+UIWeb::HttpResponse UIWeb::handleRequest(const HttpRequest& req){
+    // separa a query string antes de decodificar (ela pode conter '&' e '=' codificados)
+    auto q = req.path.find('?');
+    std::string query = q == std::string_view::npos ? "" : std::string(req.path.substr(q + 1));
+
     // normaliza path
-    path = urlDecode(path);
+    std::string path = urlDecode(req.path.substr(0, q));
+    const auto route = routeOf(req.method, path);
+    const auto start = std::chrono::steady_clock::now();
+
+    HttpResponse r;
     if (path.find("..") != std::string::npos) { // evita traversal
-        auto r = httpResponse(400,"Bad Request","text/plain","bad path");
-        ::send(sock, r.data(), (int)r.size(), 0);
-        return;
+        r = httpResponse(400,"Bad Request","text/plain","bad path");
+    }
+    else if (route == WebMetrics::Metrics) {
+        r = httpResponse(200,"OK","text/plain; version=0.0.4; charset=utf-8",
+                         metrics_.render(sse_.clientCount()));
+    }
+    else if (isApi(path)) {
+        r = handleApi(req.method, path, query, req.body);
+        if (r.stream && !req.http11) {
+            // HTTP/1.0 não conhece chunked: gera o corpo inteiro
+            while (r.stream(r.body)) {}
+            r.stream = nullptr;
+        }
+    }
+    else {
+        r = handleStatic(path, req);
     }
 
-    if (isApi(path)) {
-        handleApi(method, path, body, sock);
-    } else {
-        handleStatic(path, sock);
+    // respostas chunked: mede até o handler devolver, não a geração dos pedaços
+    metrics_.observe(route, r.status, std::chrono::steady_clock::now() - start);
+    return r;
+}
+
+WebMetrics::Route UIWeb::routeOf(std::string_view method, const std::string& path){
+    static const std::string item = "/api/disciplinas/";
+    if (path == "/metrics" && method == "GET") return WebMetrics::Metrics;
+    if (path.rfind("/api/", 0) != 0)           return WebMetrics::Static;
+    if (path == "/api/disciplinas") {
+        if (method == "GET")  return WebMetrics::ApiList;
+        if (method == "POST") return WebMetrics::ApiInsert;
+    }
+    else if (path == "/api/disciplinas/batch") {
+        if (method == "POST") return WebMetrics::ApiBatch;
+    }
+    else if (path.rfind(item, 0) == 0) {
+        if (method == "GET")    return WebMetrics::ApiGet;
+        if (method == "PUT")    return WebMetrics::ApiUpdate;
+        if (method == "DELETE") return WebMetrics::ApiRemove;
+    }
+    else if (path == "/api/cr" && method == "GET") {
+        return WebMetrics::ApiCr;
     }
+    else if (path == "/api/estatisticas" && method == "GET") {
+        return WebMetrics::ApiEstatisticas;
+    }
+    return WebMetrics::ApiOther;
 }
 
 bool UIWeb::isApi(const std::string& path) const {
     return path.rfind("/api/", 0) == 0;
 }
 
-void UIWeb::handleApi(const std::string& method, const std::string& path,
-                      const std::string& body, int sock)
+UIWeb::HttpResponse UIWeb::handleApi(std::string_view method, const std::string& path,
+                                     const std::string& query, std::string_view body)
 {
     try {
         // rotas:
-        // GET  /api/disciplinas
+        // GET  /api/disciplinas[?limit=&offset=&sort=&matricula=&nome=&ano=&semestre=&mediaMin=&mediaMax=]
         // GET  /api/disciplinas/{id}
         // POST /api/disciplinas
+        // POST /api/disciplinas/batch
         // PUT  /api/disciplinas/{id}
         // DELETE /api/disciplinas/{id}
         // GET  /api/cr
+        // GET  /api/estatisticas  (por período e acumulado; ver DisciplinaEstatisticas)
+        // GET  /api/events  (text/event-stream; tratado antes, em handleClient/dispatch)
 
         if (path == "/api/disciplinas" && method == "GET") {
-            Json arr = Json::array();
-            for (auto& d : svc_.list()) arr.push_back(disciplinaToJson(d));
-            auto r = httpJson(200,"OK", arr.dump());
-            ::send(sock, r.data(), (int)r.size(), 0);
-            return;
+            // só a página pedida é buscada; o total filtrado vai no header.
+            // O JSON é gerado aos pedaços durante o envio, sem DOM intermediário.
+            auto page = svc_.query(parseDisciplinaQuery(query));
+            auto arr = std::make_shared<DisciplinaJsonArrayStream>(std::move(page.items), STREAM_CHUNK_SIZE);
+            auto r = httpJson(200,"OK", "");
+            r.stream = [arr](std::string& out){ return arr->next(out); };
+            r.headers.emplace_back("X-Total-Count", std::to_string(page.total));
+            return r;
+        }
+
+        if (path == "/api/disciplinas/batch" && method == "POST") {
+            // lote: validado por inteiro e gravado uma vez pelo service
+            Json j = Json::parse(body);
+            if (!j.is_array())
+                throw BusinessError("O lote deve ser um array de operacoes.");
+            std::vector<DisciplinaOperacao> ops;
+            ops.reserve(j.size());
+            for (size_t i = 0; i < j.size(); ++i)
+                ops.push_back(operacaoFromJson(j[i], i));
+            Json resp; resp["ids"] = svc_.applyBatch(ops);
+            return httpJson(200,"OK", resp.dump());
         }
 
         if (path.rfind("/api/disciplinas/", 0) == 0) {
@@ -210,23 +699,19 @@ void UIWeb::handleApi(const std::string& method, const std::string& path,
             if (method == "GET") {
                 int id = std::stoi(tail);
                 auto d = svc_.get(id);
-                auto r = httpJson(200,"OK", disciplinaToJson(d).dump());
-                ::send(sock, r.data(), (int)r.size(), 0);
-                return;
+                std::string out;
+                DisciplinaJsonWriter::append(out, d);
+                return httpJson(200,"OK", std::move(out));
             } else if (method == "PUT") {
                 int id = std::stoi(tail);
                 Json j = Json::parse(body);
                 auto d = disciplinaFromJson(j);
                 svc_.update(id, d);
-                auto r = httpJson(200,"OK", R"({"ok":true})");
-                ::send(sock, r.data(), (int)r.size(), 0);
-                return;
+                return httpJson(200,"OK", R"({"ok":true})");
             } else if (method == "DELETE") {
                 int id = std::stoi(tail);
                 svc_.remove(id);
-                auto r = httpJson(200,"OK", R"({"ok":true})");
-                ::send(sock, r.data(), (int)r.size(), 0);
-                return;
+                return httpJson(200,"OK", R"({"ok":true})");
             }
         }
 
@@ -235,62 +720,147 @@ void UIWeb::handleApi(const std::string& method, const std::string& path,
             Disciplina d = disciplinaFromJson(j);
             int id = svc_.insert(d);
             Json resp; resp["id"] = id;
-            auto r = httpJson(201,"Created", resp.dump());
-            ::send(sock, r.data(), (int)r.size(), 0);
-            return;
+            return httpJson(201,"Created", resp.dump());
+        }
+
+        if (path == "/api/estatisticas" && method == "GET") {
+            return httpJson(200,"OK", estatisticasToJson(svc_.statistics()).dump());
         }
 
         if (path == "/api/cr" && method == "GET") {
             double cr = svc_.calculateCR();
             Json j; j["cr"] = cr;
-            auto r = httpJson(200,"OK", j.dump());
-            ::send(sock, r.data(), (int)r.size(), 0);
-            return;
+            return httpJson(200,"OK", j.dump());
         }
 
-        auto r = httpJson(404,"Not Found", R"({"error":"rota nao encontrada"})");
-        ::send(sock, r.data(), (int)r.size(), 0);
+        return httpJson(404,"Not Found", R"({"error":"rota nao encontrada"})");
     }
     catch (const BusinessError& e){
         Json j; j["error"] = e.what();
-        auto r = httpJson(400,"Bad Request", j.dump());
-        ::send(sock, r.data(), (int)r.size(), 0);
+        return httpJson(400,"Bad Request", j.dump());
     }
     catch (const InfraError& e){
         Json j; j["error"] = "infra";
-        auto r = httpJson(500,"Internal Server Error", j.dump());
-        ::send(sock, r.data(), (int)r.size(), 0);
+        return httpJson(500,"Internal Server Error", j.dump());
     }
     catch (const std::exception& e){
         Json j; j["error"] = "unexpected";
-        auto r = httpJson(500,"Internal Server Error", j.dump());
-        ::send(sock, r.data(), (int)r.size(), 0);
+        return httpJson(500,"Internal Server Error", j.dump());
     }
 }
 
-void UIWeb::handleStatic(const std::string& path, int sock){
-    std::string p = path;
+UIWeb::HttpResponse UIWeb::handleStatic(const std::string& path, const HttpRequest& req){
+    std::string p = path.substr(0, path.find('?'));
     if (p == "/") p = "/index.html";
-    std::string full = docroot_ + p;
-    std::string body = readFile(full);
-    if (body.empty()) {
-        auto r = httpResponse(404,"Not Found","text/plain","404 not found");
-        ::send(sock, r.data(), (int)r.size(), 0);
-        return;
+
+    auto entry = cache_.find(p);
+    if (!entry) {
+        return httpResponse(404,"Not Found","text/plain","404 not found");
+    }
+
+    // escolhe a variante antes: cada codificação tem o seu ETag
+    const char* coding = nullptr;
+    const std::string* etag = &entry->etag;
+    std::shared_ptr<const std::string> body = entry->body;
+    if (entry->body && entry->gzipBody && acceptsEncoding(req.acceptEncoding, "gzip")) {
+        coding = "gzip";
+        etag = &entry->gzipEtag;
+        body = entry->gzipBody;
+    } else if (entry->body && entry->deflateBody && acceptsEncoding(req.acceptEncoding, "deflate")) {
+        coding = "deflate";
+        etag = &entry->deflateEtag;
+        body = entry->deflateBody;
+    }
+
+    HttpResponse r;
+    r.contentType = entry->contentType;
+    r.headers.emplace_back("ETag", *etag);
+    // o navegador guarda a cópia, mas revalida sempre (barato: 304 sem corpo)
+    r.headers.emplace_back("Cache-Control", "no-cache");
+    r.headers.emplace_back("Vary", "Accept-Encoding");
+
+    if (!req.ifNoneMatch.empty() && etagMatches(req.ifNoneMatch, *etag)) {
+        r.status = 304;
+        r.statusText = "Not Modified";
+        return r;
+    }
+
+    if (coding)
+        r.headers.emplace_back("Content-Encoding", coding);
+    if (body) {
+        r.sharedBody = std::move(body);
+    } else {
+        // fora do cache (arquivo grande): vai direto do disco para o socket
+        r.filePath = entry->fullPath;
+    }
+    return r;
+}
+
+bool UIWeb::etagMatches(std::string_view ifNoneMatch, std::string_view etag){
+    auto opaque = [](std::string_view t){
+        while (!t.empty() && (unsigned char)t.front() <= 32) t.remove_prefix(1);
+        while (!t.empty() && (unsigned char)t.back()  <= 32) t.remove_suffix(1);
+        if (t.size() >= 2 && t[0] == 'W' && t[1] == '/') t.remove_prefix(2);
+        return t;
+    };
+    const std::string_view mine = opaque(etag);
+    std::string_view rest = ifNoneMatch;
+    while (!rest.empty()) {
+        auto comma = rest.find(',');
+        std::string_view item = opaque(rest.substr(0, comma));
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        if (item == "*" || (!item.empty() && item == mine)) return true;
+    }
+    return false;
+}
+
+// verifica se 'coding' aparece em Accept-Encoding sem q=0
+bool UIWeb::acceptsEncoding(std::string_view acceptEncoding, std::string_view coding){
+    auto trim = [](std::string_view s){
+        while (!s.empty() && (unsigned char)s.front() <= 32) s.remove_prefix(1);
+        while (!s.empty() && (unsigned char)s.back()  <= 32) s.remove_suffix(1);
+        return s;
+    };
+    auto sameNoCase = [](std::string_view a, std::string_view b){
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](char x, char y){
+                   return std::tolower((unsigned char)x) == std::tolower((unsigned char)y);
+               });
+    };
+    std::string_view rest = acceptEncoding;
+    while (!rest.empty()) {
+        auto comma = rest.find(',');
+        std::string_view item = rest.substr(0, comma);
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+
+        auto semi = item.find(';');
+        std::string_view name = trim(item.substr(0, semi));
+        if (!sameNoCase(name, coding) && name != "*") continue;
+        if (semi == std::string_view::npos) return true;
+        std::string_view params = item.substr(semi + 1);
+        auto qpos = params.find("q=");
+        if (qpos == std::string_view::npos) return true;
+        params = trim(params.substr(qpos + 2));
+        // qvalue: só dígitos e ponto; recusado quando é zero ("0", "0.0"...)
+        if (params.empty() || params.find_first_not_of("0123456789.") != std::string_view::npos)
+            return false;
+        return params.find_first_not_of("0.") != std::string_view::npos;
     }
-    auto ct = guessMime(p);
-    auto r = httpResponse(200,"OK", ct, body);
-    ::send(sock, r.data(), (int)r.size(), 0);
+    return false;
 }
 
-std::string UIWeb::urlDecode(const std::string& s){
+std::string UIWeb::urlDecode(std::string_view s){
+    auto hexValue = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
     std::string out; out.reserve(s.size());
     for (size_t i=0;i<s.size();++i){
         if (s[i]=='%' && i+2<s.size()){
-            int v = 0;
-            std::istringstream is(s.substr(i+1,2));
-            is >> std::hex >> v;
-            out.push_back((char)v);
+            int hi = hexValue(s[i+1]), lo = hexValue(s[i+2]);
+            out.push_back((char)(hi < 0 || lo < 0 ? 0 : hi * 16 + lo));
             i+=2;
         } else if (s[i]=='+') {
             out.push_back(' ');
@@ -299,43 +869,256 @@ std::string UIWeb::urlDecode(const std::string& s){
     return out;
 }
 
-std::string UIWeb::guessMime(const std::string& path){
-    auto dot = path.find_last_of('.');
-    std::string ext = (dot==std::string::npos) ? "" : path.substr(dot+1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    if (ext=="html") return "text/html; charset=utf-8";
-    if (ext=="js")   return "application/javascript; charset=utf-8";
-    if (ext=="css")  return "text/css; charset=utf-8";
-    if (ext=="png")  return "image/png";
-    if (ext=="jpg" || ext=="jpeg") return "image/jpeg";
-    if (ext=="ico")  return "image/x-icon";
-    if (ext=="json") return "application/json; charset=utf-8";
-    return "text/plain; charset=utf-8";
+UIWeb::HttpResponse UIWeb::httpResponse(int status, const std::string& statusText,
+                                        const std::string& contentType,
+                                        std::string body)
+{
+    HttpResponse r;
+    r.status = status;
+    r.statusText = statusText;
+    r.contentType = contentType;
+    r.body = std::move(body);
+    r.headers.emplace_back("Cache-Control", "no-store");
+    return r;
 }
 
-std::string UIWeb::readFile(const std::string& path){
-    std::ifstream f(path, std::ios::binary);
-    if (!f) return {};
-    std::ostringstream ss; ss << f.rdbuf();
-    return ss.str();
+UIWeb::WireResponse::~WireResponse()
+{
+#ifndef _WIN32
+    if (fileFd >= 0) ::close(fileFd);
+#endif
 }
 
-std::string UIWeb::httpResponse(int status, const std::string& statusText,
-                                const std::string& contentType,
-                                const std::string& body)
+std::unique_ptr<UIWeb::WireResponse> UIWeb::toWire(HttpResponse&& resp, bool keepAlive) const
 {
+    auto w = std::make_unique<WireResponse>();
+    w->body = std::move(resp.body);
+    w->sharedBody = std::move(resp.sharedBody);
+    w->stream = std::move(resp.stream);
+    uint64_t bodyLen = w->sharedBody ? w->sharedBody->size() : w->body.size();
+
+    if (!resp.filePath.empty()) {
+#ifdef __linux__
+        int fd = ::open(resp.filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st{};
+        if (fd < 0 || ::fstat(fd, &st) != 0) {
+            if (fd >= 0) ::close(fd);
+            return toWire(httpResponse(404,"Not Found","text/plain","404 not found"), keepAlive);
+        }
+        w->fileFd = fd;
+        w->fileRemaining = (uint64_t)st.st_size;
+        bodyLen = w->fileRemaining;
+#else
+        // sem sendfile: lê o arquivo para a memória
+        std::ifstream f(resp.filePath, std::ios::binary);
+        if (!f)
+            return toWire(httpResponse(404,"Not Found","text/plain","404 not found"), keepAlive);
+        std::ostringstream ss; ss << f.rdbuf();
+        w->body = ss.str();
+        bodyLen = w->body.size();
+#endif
+    }
+
     std::ostringstream ss;
-    ss << "HTTP/1.1 " << status << ' ' << statusText << "\r\n";
-    ss << "Content-Type: " << contentType << "\r\n";
-    ss << "Content-Length: " << body.size() << "\r\n";
-    ss << "Connection: close\r\n";
-    ss << "Cache-Control: no-store\r\n";
+    ss << "HTTP/1.1 " << resp.status << ' ' << resp.statusText << "\r\n";
+    ss << "Content-Type: " << resp.contentType << "\r\n";
+    if (w->stream) {
+        // primeiro pedaço já vai junto com o cabeçalho
+        ss << "Transfer-Encoding: chunked\r\n";
+        fillChunk(*w, w->body);
+    } else if (resp.status != 304) {
+        ss << "Content-Length: " << bodyLen << "\r\n";
+    }
+    if (keepAlive) {
+        ss << "Connection: keep-alive\r\n";
+        ss << "Keep-Alive: timeout=" << keepAliveTimeout_ << "\r\n";
+    } else {
+        ss << "Connection: close\r\n";
+    }
+    for (const auto& h : resp.headers)
+        ss << h.first << ": " << h.second << "\r\n";
     ss << "\r\n";
-    ss << body;
-    return ss.str();
+    w->head = ss.str();
+    return w;
 }
-std::string UIWeb::httpJson(int status, const std::string& statusText,
-                            const std::string& jsonBody)
+
+int UIWeb::writeSome(int sock, WireResponse& w){
+    const std::string& body = w.sharedBody ? *w.sharedBody : w.body;
+    const size_t memTotal = w.head.size() + body.size();
+
+    // cabeçalho + corpo em memória
+    while (w.pos < memTotal) {
+#ifdef _WIN32
+        bool inHead = w.pos < w.head.size();
+        const std::string& part = inHead ? w.head : body;
+        size_t off = inHead ? w.pos : w.pos - w.head.size();
+        int n = ::send(sock, part.data() + off, (int)(part.size() - off), 0);
+        if (n <= 0) return -1;
+#else
+        iovec iov[2];
+        int cnt = 0;
+        if (w.pos < w.head.size()) {
+            iov[cnt].iov_base = const_cast<char*>(w.head.data() + w.pos);
+            iov[cnt].iov_len  = w.head.size() - w.pos;
+            ++cnt;
+            if (!body.empty()) {
+                iov[cnt].iov_base = const_cast<char*>(body.data());
+                iov[cnt].iov_len  = body.size();
+                ++cnt;
+            }
+        } else {
+            size_t off = w.pos - w.head.size();
+            iov[cnt].iov_base = const_cast<char*>(body.data() + off);
+            iov[cnt].iov_len  = body.size() - off;
+            ++cnt;
+        }
+        ssize_t n = ::writev(sock, iov, cnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return -1;
+        }
+#endif
+        w.pos += (size_t)n;
+        w.sent += (uint64_t)n;
+    }
+
+#ifdef __linux__
+    // corpo em arquivo: o kernel copia direto do page cache para o socket
+    while (w.fileRemaining > 0) {
+        off_t off = (off_t)w.fileOffset;
+        size_t chunk = (size_t)std::min<uint64_t>(w.fileRemaining, 1u << 30);
+        ssize_t n = ::sendfile(sock, w.fileFd, &off, chunk);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return -1;
+        }
+        if (n == 0) return -1; // arquivo encolheu durante o envio
+        w.fileOffset = (uint64_t)off;
+        w.fileRemaining -= (uint64_t)n;
+        w.sent += (uint64_t)n;
+    }
+#endif
+
+    // corpo chunked: gera o próximo pedaço só quando o anterior foi enviado
+    while (w.chunkPos < w.chunk.size() || w.stream) {
+        if (w.chunkPos == w.chunk.size()) {
+            w.chunk.clear();
+            w.chunkPos = 0;
+            fillChunk(w, w.chunk);
+            continue;
+        }
+#ifdef _WIN32
+        int n = ::send(sock, w.chunk.data() + w.chunkPos, (int)(w.chunk.size() - w.chunkPos), 0);
+        if (n <= 0) return -1;
+#else
+        ssize_t n = ::send(sock, w.chunk.data() + w.chunkPos, w.chunk.size() - w.chunkPos, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return -1;
+        }
+#endif
+        w.chunkPos += (size_t)n;
+        w.sent += (uint64_t)n;
+    }
+    return 1;
+}
+
+int UIWeb::writeCounted(int sock, WireResponse& w){
+    const uint64_t before = w.sent;
+    int st = writeSome(sock, w);
+    metrics_.addBytesOut(w.sent - before);
+    return st;
+}
+
+void UIWeb::fillChunk(WireResponse& w, std::string& out){
+    static const char* hex = "0123456789abcdef";
+    // tamanho em 8 dígitos hexa (zeros à esquerda são válidos), preenchido depois
+    const size_t start = out.size();
+    out.append("00000000\r\n");
+    const bool more = w.stream(out);
+    const size_t len = out.size() - start - 10;
+    if (len == 0) {
+        out.resize(start);
+    } else {
+        for (int i = 7; i >= 0; --i)
+            out[start + (7 - i)] = hex[(len >> (i * 4)) & 0xF];
+        out += "\r\n";
+    }
+    if (!more) {
+        out += "0\r\n\r\n";
+        w.stream = nullptr;
+    }
+}
+
+DisciplinaQuery UIWeb::parseDisciplinaQuery(const std::string& query){
+    DisciplinaQuery q;
+
+    auto toInt = [](const std::string& name, const std::string& v){
+        size_t pos = 0;
+        int n = 0;
+        try { n = std::stoi(v, &pos); } catch (const std::exception&) { pos = 0; }
+        if (pos == 0 || pos != v.size())
+            throw BusinessError("Parametro '" + name + "' invalido: " + v);
+        return n;
+    };
+    auto toDouble = [](const std::string& name, const std::string& v){
+        size_t pos = 0;
+        double n = 0;
+        try { n = std::stod(v, &pos); } catch (const std::exception&) { pos = 0; }
+        if (pos == 0 || pos != v.size())
+            throw BusinessError("Parametro '" + name + "' invalido: " + v);
+        return n;
+    };
+
+    size_t start = 0;
+    while (start <= query.size()) {
+        size_t amp = query.find('&', start);
+        if (amp == std::string::npos) amp = query.size();
+        std::string pair = query.substr(start, amp - start);
+        start = amp + 1;
+        if (pair.empty()) continue;
+
+        size_t eq = pair.find('=');
+        std::string name  = urlDecode(pair.substr(0, eq));
+        std::string value = eq == std::string::npos ? "" : urlDecode(pair.substr(eq + 1));
+        if (value.empty()) continue;
+
+        if (name == "limit") {
+            q.limit = toInt(name, value);
+            if (q.limit < 0) throw BusinessError("Parametro 'limit' deve ser maior ou igual a 0.");
+        }
+        else if (name == "offset") {
+            q.offset = toInt(name, value);
+            if (q.offset < 0) throw BusinessError("Parametro 'offset' deve ser maior ou igual a 0.");
+        }
+        else if (name == "sort") {
+            q.desc = value[0] == '-';
+            std::string field = q.desc ? value.substr(1) : value;
+            if      (field == "id")        q.sort = DisciplinaSort::Id;
+            else if (field == "matricula") q.sort = DisciplinaSort::Matricula;
+            else if (field == "nome")      q.sort = DisciplinaSort::Nome;
+            else if (field == "ano")       q.sort = DisciplinaSort::Ano;
+            else if (field == "semestre")  q.sort = DisciplinaSort::Semestre;
+            else if (field == "creditos")  q.sort = DisciplinaSort::Creditos;
+            else if (field == "media")     q.sort = DisciplinaSort::Media;
+            else throw BusinessError("Parametro 'sort' invalido: " + value);
+        }
+        else if (name == "matricula") q.matricula = value;
+        else if (name == "nome")      q.nome      = value;
+        else if (name == "ano")       q.ano       = toInt(name, value);
+        else if (name == "semestre")  q.semestre  = toInt(name, value);
+        else if (name == "mediaMin")  q.mediaMin  = toDouble(name, value);
+        else if (name == "mediaMax")  q.mediaMax  = toDouble(name, value);
+        // parametros desconhecidos sao ignorados
+    }
+    return q;
+}
+
+UIWeb::HttpResponse UIWeb::httpJson(int status, const std::string& statusText,
+                                    std::string jsonBody)
 {
-    return httpResponse(status, statusText, "application/json; charset=utf-8", jsonBody);
+    return httpResponse(status, statusText, "application/json; charset=utf-8", std::move(jsonBody));
 }
@@ -1,39 +1,139 @@
 #ifndef _UI_WEB_HPP_
 #define _UI_WEB_HPP_
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include "IUserInterface.hpp"
 #include "Configuracao.hpp"
 #include "IHistoricoService.hpp"
 #include "ILogger.hpp"
+#include "SynchronizedHistoricoService.hpp"
+#include "StaticFileCache.hpp"
+#include "SseHub.hpp"
+#include "WebMetrics.hpp"
+#include "HttpParser.hpp"
 
+// UI HTTP (API REST + arquivos estáticos do SPA em www/).
+//
+// Modos de I/O (WEB_IO_MODE):
+// - "threads": accept bloqueante; cada conexão é atendida por uma thread do pool.
+//              Uma conexão keep-alive ocupa a thread até o timeout de ociosidade,
+//              então ela só continua aberta enquanto as conexões do pool (esta
+//              inclusa) couberem em metade de WEB_THREADS; acima disso a resposta
+//              sai com Connection: close. Com WEB_THREADS=1 nunca há keep-alive.
+// - "epoll"  : (Linux) um único laço de eventos com sockets não bloqueantes
+//              faz todo o I/O; só o processamento da requisição vai para o pool.
+//
+// Fora esse limite do modo "threads", as conexões são persistentes
+// (HTTP/1.1 keep-alive), com requisições em pipeline respondidas na ordem de
+// chegada, fechadas após WEB_KEEPALIVE_TIMEOUT segundos ociosas ou
+// WEB_KEEPALIVE_MAX requisições.
+//
+// GET /api/events é um feed Server-Sent Events com as alterações feitas no
+// service; o socket sai do modo de I/O acima e passa para o SseHub.
+// GET /metrics expõe contadores e latências no formato do Prometheus.
 class UIWeb : public IUserInterface {
 public:
     UIWeb(IHistoricoService& service, ILogger& logger, const Configuracao& conf);
+    ~UIWeb() override;
     void run() override;
 
+    // Resposta pronta para o socket: cabeçalho + corpo em memória (writev)
+    // e, se houver, um arquivo enviado com sendfile.
+    struct WireResponse {
+        std::string head;
+        std::string body;
+        std::shared_ptr<const std::string> sharedBody;
+        int fileFd = -1;
+        std::uint64_t fileOffset = 0;
+        std::uint64_t fileRemaining = 0;
+        std::size_t pos = 0;        // bytes de head+corpo já enviados
+        // corpo chunked gerado sob demanda, um pedaço por vez em 'chunk'
+        std::function<bool(std::string&)> stream;
+        std::string chunk;
+        std::size_t chunkPos = 0;
+        std::uint64_t sent = 0;     // total escrito no socket (métricas)
+
+        WireResponse() = default;
+        WireResponse(const WireResponse&) = delete;
+        WireResponse& operator=(const WireResponse&) = delete;
+        ~WireResponse();
+    };
+
 private:
-    IHistoricoService& svc_;
+    // views para o buffer do HttpParser da conexão: valem até parser.next()
+    using HttpRequest = HttpParser::Request;
+
+    struct HttpResponse {
+        int status = 200;
+        std::string statusText = "OK";
+        std::string contentType;
+        std::string body;
+        std::shared_ptr<const std::string> sharedBody; // corpo do cache, sem cópia
+        std::string filePath;                          // corpo lido do disco (sendfile)
+        // corpo gerado aos pedaços: acrescenta o próximo pedaço e retorna
+        // false no último (enviado com Transfer-Encoding: chunked)
+        std::function<bool(std::string&)> stream;
+        std::vector<std::pair<std::string, std::string>> headers; // extras
+    };
+
+    SynchronizedHistoricoService svc_; // acessado por várias threads
     ILogger& log;
     int port_;
+    int threads_;
+    std::string ioMode_;
+    int keepAliveTimeout_;  // segundos ociosos antes de fechar (0 = sem keep-alive)
+    int keepAliveMax_;      // máximo de requisições por conexão
+    std::atomic<int> poolConns_{0}; // modo threads: conexões aceitas ainda no pool
     std::string docroot_;
+    StaticFileCache cache_;
+    SseHub sse_;            // clientes de GET /api/events
+    WebMetrics metrics_;
 
+    int openListenSocket();
     void serveLoop();
-    void handleClient(int sock);
-    void handleRequest(const std::string& req, int sock);
+    void serveLoopEpoll();
+    // false quando o socket foi entregue ao SseHub (não deve ser fechado)
+    bool handleClient(int sock);
+    static bool isEventStream(const HttpRequest& req);
+    void publishChange(const DisciplinaEvento& ev);
+    HttpResponse handleRequest(const HttpRequest& req);
     bool isApi(const std::string& path) const;
-    void handleApi(const std::string& method, const std::string& path,
-                   const std::string& body, int sock);
-    void handleStatic(const std::string& path, int sock);
-
-    static std::string urlDecode(const std::string& s);
-    static std::string guessMime(const std::string& path);
-    static std::string httpResponse(int status, const std::string& statusText,
-                                    const std::string& contentType,
-                                    const std::string& body);
-    static std::string httpJson(int status, const std::string& statusText,
-                                const std::string& jsonBody);
-    static std::string readFile(const std::string& path);
+    static WebMetrics::Route routeOf(std::string_view method, const std::string& path);
+    HttpResponse handleApi(std::string_view method, const std::string& path,
+                           const std::string& query, std::string_view body);
+    HttpResponse handleStatic(const std::string& path, const HttpRequest& req);
+    std::unique_ptr<WireResponse> toWire(HttpResponse&& resp, bool keepAlive) const;
+
+    // resposta de erro para uma requisição recusada pelo parser
+    static HttpResponse parseError(const HttpParser& parser);
+
+    // Envia o que for possível de 'w': 1 = terminou, 0 = socket cheio
+    // (não bloqueante), -1 = erro/conexão encerrada.
+    static int writeSome(int sock, WireResponse& w);
+    // writeSome contabilizando os bytes enviados nas métricas
+    int writeCounted(int sock, WireResponse& w);
+    // Acrescenta em 'out' o próximo pedaço de w.stream no formato chunked
+    // (e o pedaço final quando o stream termina).
+    static void fillChunk(WireResponse& w, std::string& out);
+    static std::string urlDecode(std::string_view s);
+    // limit, offset, sort ("campo" ou "-campo") e filtros de GET /api/disciplinas
+    static DisciplinaQuery parseDisciplinaQuery(const std::string& query);
+    static HttpResponse httpResponse(int status, const std::string& statusText,
+                                     const std::string& contentType,
+                                     std::string body);
+    static HttpResponse httpJson(int status, const std::string& statusText,
+                                 std::string jsonBody);
+    static bool acceptsEncoding(std::string_view acceptEncoding, std::string_view coding);
+    // If-None-Match: "*" ou lista de tags separadas por vírgula; comparação
+    // fraca (W/"x" casa com "x"), como pede a RFC 9110 para esse header
+    static bool etagMatches(std::string_view ifNoneMatch, std::string_view etag);
 };
 
-#endif
\ No newline at end of file
+#endif
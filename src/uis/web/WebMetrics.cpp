@@ -0,0 +1,168 @@
+#include "WebMetrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    const char* const CLASS_LABEL[] = { "2xx", "3xx", "4xx", "5xx" };
+    const double QUANTILES[] = { 0.5, 0.95, 0.99 };
+
+    void appendSeconds(std::string& out, double seconds)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", seconds);
+        out += buf;
+    }
+}
+
+const char* WebMetrics::routeName(Route r)
+{
+    switch (r) {
+        case ApiList:   return "GET /api/disciplinas";
+        case ApiGet:    return "GET /api/disciplinas/{id}";
+        case ApiInsert: return "POST /api/disciplinas";
+        case ApiBatch:  return "POST /api/disciplinas/batch";
+        case ApiUpdate: return "PUT /api/disciplinas/{id}";
+        case ApiRemove: return "DELETE /api/disciplinas/{id}";
+        case ApiCr:     return "GET /api/cr";
+        case ApiEstatisticas: return "GET /api/estatisticas";
+        case ApiOther:  return "api (outras)";
+        case Static:    return "static";
+        case Metrics:   return "GET /metrics";
+        case RouteCount: break;
+    }
+    return "?";
+}
+
+void WebMetrics::observe(Route r, int status, std::chrono::steady_clock::duration elapsed)
+{
+    RouteStats& s = routes[r];
+    const auto us = (std::uint64_t)std::max<std::int64_t>(0,
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    const int cls = std::clamp(status / 100 - 2, 0, 3);
+    s.byClass[cls].fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t b = (std::size_t)(std::lower_bound(BUCKETS_US.begin(), BUCKETS_US.end(), us)
+                                        - BUCKETS_US.begin());
+    s.buckets[b].fetch_add(1, std::memory_order_relaxed);
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sumUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+void WebMetrics::connectionOpened()
+{
+    connTotal.fetch_add(1, std::memory_order_relaxed);
+    connActive.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WebMetrics::connectionClosed()
+{
+    connActive.fetch_sub(1, std::memory_order_relaxed);
+}
+
+double WebMetrics::quantile(const std::array<std::uint64_t, BUCKETS_US.size() + 1>& counts,
+                            std::uint64_t total, double q)
+{
+    if (total == 0)
+        return 0.0;
+    const double rank = q * (double)total;
+    std::uint64_t cum = 0;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0 || (double)(cum + counts[i]) < rank) {
+            cum += counts[i];
+            continue;
+        }
+        // acima do último limite não há como interpolar: usa o limite
+        if (i == BUCKETS_US.size())
+            return (double)BUCKETS_US.back() / 1e6;
+        const double lo = i == 0 ? 0.0 : (double)BUCKETS_US[i - 1];
+        const double hi = (double)BUCKETS_US[i];
+        return (lo + (hi - lo) * (rank - (double)cum) / (double)counts[i]) / 1e6;
+    }
+    return (double)BUCKETS_US.back() / 1e6;
+}
+
+std::string WebMetrics::render(std::size_t sseClients) const
+{
+    std::string out;
+    out.reserve(16 * 1024);
+
+    auto label = [&](Route r){
+        out += "route=\"";
+        out += routeName(r);
+        out += '"';
+    };
+
+    out += "# HELP uiweb_requests_total Requisicoes atendidas por rota e classe de status.\n";
+    out += "# TYPE uiweb_requests_total counter\n";
+    for (int r = 0; r < RouteCount; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            std::uint64_t v = routes[r].byClass[c].load(std::memory_order_relaxed);
+            if (v == 0) continue;
+            out += "uiweb_requests_total{"; label((Route)r);
+            out += ",code=\""; out += CLASS_LABEL[c]; out += "\"} ";
+            out += std::to_string(v); out += '\n';
+        }
+    }
+
+    // cópia dos baldes por rota: o histograma e os quantis saem do mesmo retrato
+    std::array<std::array<std::uint64_t, BUCKETS_US.size() + 1>, RouteCount> snap{};
+    std::array<std::uint64_t, RouteCount> totals{};
+    for (int r = 0; r < RouteCount; ++r) {
+        for (std::size_t b = 0; b < snap[r].size(); ++b) {
+            snap[r][b] = routes[r].buckets[b].load(std::memory_order_relaxed);
+            totals[r] += snap[r][b];
+        }
+    }
+
+    out += "# HELP uiweb_request_duration_seconds Tempo de processamento da requisicao (handler).\n";
+    out += "# TYPE uiweb_request_duration_seconds histogram\n";
+    for (int r = 0; r < RouteCount; ++r) {
+        if (totals[r] == 0) continue;
+        std::uint64_t cum = 0;
+        for (std::size_t b = 0; b < snap[r].size(); ++b) {
+            cum += snap[r][b];
+            out += "uiweb_request_duration_seconds_bucket{"; label((Route)r);
+            out += ",le=\"";
+            if (b < BUCKETS_US.size()) appendSeconds(out, (double)BUCKETS_US[b] / 1e6);
+            else out += "+Inf";
+            out += "\"} ";
+            out += std::to_string(cum); out += '\n';
+        }
+        out += "uiweb_request_duration_seconds_sum{"; label((Route)r); out += "} ";
+        appendSeconds(out, (double)routes[r].sumUs.load(std::memory_order_relaxed) / 1e6);
+        out += '\n';
+        out += "uiweb_request_duration_seconds_count{"; label((Route)r); out += "} ";
+        out += std::to_string(totals[r]); out += '\n';
+    }
+
+    out += "# HELP uiweb_request_duration_quantile_seconds p50/p95/p99 estimados do histograma.\n";
+    out += "# TYPE uiweb_request_duration_quantile_seconds gauge\n";
+    for (int r = 0; r < RouteCount; ++r) {
+        if (totals[r] == 0) continue;
+        for (double q : QUANTILES) {
+            out += "uiweb_request_duration_quantile_seconds{"; label((Route)r);
+            out += ",quantile=\""; appendSeconds(out, q); out += "\"} ";
+            appendSeconds(out, quantile(snap[r], totals[r], q));
+            out += '\n';
+        }
+    }
+
+    out += "# HELP uiweb_received_bytes_total Bytes lidos dos sockets.\n";
+    out += "# TYPE uiweb_received_bytes_total counter\n";
+    out += "uiweb_received_bytes_total " + std::to_string(bytesIn.load(std::memory_order_relaxed)) + "\n";
+    out += "# HELP uiweb_sent_bytes_total Bytes escritos nos sockets (exceto SSE).\n";
+    out += "# TYPE uiweb_sent_bytes_total counter\n";
+    out += "uiweb_sent_bytes_total " + std::to_string(bytesOut.load(std::memory_order_relaxed)) + "\n";
+    out += "# HELP uiweb_connections_total Conexoes aceitas.\n";
+    out += "# TYPE uiweb_connections_total counter\n";
+    out += "uiweb_connections_total " + std::to_string(connTotal.load(std::memory_order_relaxed)) + "\n";
+    out += "# HELP uiweb_connections_active Conexoes HTTP abertas (sem contar SSE).\n";
+    out += "# TYPE uiweb_connections_active gauge\n";
+    out += "uiweb_connections_active " + std::to_string(connActive.load(std::memory_order_relaxed)) + "\n";
+    out += "# HELP uiweb_sse_clients Clientes conectados em /api/events.\n";
+    out += "# TYPE uiweb_sse_clients gauge\n";
+    out += "uiweb_sse_clients " + std::to_string(sseClients) + "\n";
+    return out;
+}
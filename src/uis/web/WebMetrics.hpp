@@ -0,0 +1,70 @@
+#ifndef _WEB_METRICS_HPP_
+#define _WEB_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Métricas da UIWeb expostas em GET /metrics (formato texto do Prometheus).
+//
+// - Contadores por rota e classe de status, histograma de latência por rota
+//   (baldes fixos) e p50/p95/p99 estimados a partir do histograma.
+// - Bytes recebidos/enviados e conexões ativas.
+// - Tudo é std::atomic com memory_order_relaxed: registrar uma requisição
+//   custa alguns incrementos, sem lock; só render() percorre os contadores.
+//   Uma leitura concorrente pode ver uma requisição "pela metade", o que é
+//   aceitável para métricas.
+
+class WebMetrics {
+    public:
+        // rotas fixas (não o path bruto, para não criar séries sem limite)
+        enum Route {
+            ApiList, ApiGet, ApiInsert, ApiBatch, ApiUpdate, ApiRemove,
+            ApiCr, ApiEstatisticas, ApiOther, Static, Metrics,
+            RouteCount
+        };
+
+        static const char* routeName(Route r);
+
+        void observe(Route r, int status, std::chrono::steady_clock::duration elapsed);
+
+        void addBytesIn(std::uint64_t n)  { bytesIn.fetch_add(n, std::memory_order_relaxed); }
+        void addBytesOut(std::uint64_t n) { bytesOut.fetch_add(n, std::memory_order_relaxed); }
+        void connectionOpened();
+        void connectionClosed();
+
+        // 'sseClients' vem do SseHub, que conta as próprias conexões
+        std::string render(std::size_t sseClients) const;
+
+    private:
+        // limites superiores dos baldes, em microssegundos (o último é +Inf)
+        static constexpr std::array<std::uint64_t, 14> BUCKETS_US{
+            100, 250, 500, 1000, 2500, 5000, 10000, 25000,
+            50000, 100000, 250000, 500000, 1000000, 2500000
+        };
+
+        // uma linha de cache por rota: threads atendendo rotas diferentes
+        // não disputam a mesma linha
+        struct alignas(64) RouteStats {
+            std::array<std::atomic<std::uint64_t>, 4> byClass{};  // 2xx..5xx
+            std::array<std::atomic<std::uint64_t>, BUCKETS_US.size() + 1> buckets{};
+            std::atomic<std::uint64_t> count{0};
+            std::atomic<std::uint64_t> sumUs{0};
+        };
+
+        std::array<RouteStats, RouteCount> routes;
+        std::atomic<std::uint64_t> bytesIn{0};
+        std::atomic<std::uint64_t> bytesOut{0};
+        std::atomic<std::uint64_t> connTotal{0};
+        std::atomic<std::int64_t> connActive{0};
+
+        // quantil 'q' (0..1) por interpolação linear dentro do balde,
+        // como o histogram_quantile do Prometheus
+        static double quantile(const std::array<std::uint64_t, BUCKETS_US.size() + 1>& counts,
+                               std::uint64_t total, double q);
+};
+
+#endif
@@ -1,20 +1,31 @@
 // Pequeno cliente para a API do servidor C++
 // Endpoints (da implementação fornecida):
-// GET    /api/disciplinas
+// GET    /api/disciplinas  (?limit, offset, sort=campo|-campo, matricula, nome,
+//                           ano, semestre, mediaMin, mediaMax; total em X-Total-Count)
 // GET    /api/disciplinas/{id}
 // POST   /api/disciplinas
+// POST   /api/disciplinas/batch  ([{op:"insert"|"update"|"remove", id, disciplina}] -> {ids})
 // PUT    /api/disciplinas/{id}
 // DELETE /api/disciplinas/{id}
 // GET    /api/cr
+// GET    /api/estatisticas  ({geral, periodos:[{ano, semestre, periodo, acumulado}]})
+// GET    /api/events  (Server-Sent Events: insert/update/remove/reset, cada um com o CR)
+//
+// A lista é pedida uma página por vez, já filtrada pelo servidor: o
+// tráfego acompanha o tamanho da página, não o do histórico.
 
 const $ = (sel, root=document) => root.querySelector(sel);
 const $$ = (sel, root=document) => Array.from(root.querySelectorAll(sel));
 
+const PAGE_SIZE = 50;
+
 const state = {
-  data: [],
-  filtered: [],
+  rows: [],     // página atual, como veio do servidor
+  total: 0,     // X-Total-Count: quantas atendem ao filtro
+  offset: 0,
   selectedIndex: 0,
-  filtro: ""
+  filtro: "",
+  live: false   // feed /api/events conectado: a lista se atualiza sozinha
 };
 
 // ======= Modal infra (focus-trap e lock da Home) =======
@@ -111,35 +122,118 @@ async function parseApiError(r){
 }
 
 // ======= Carregar dados =======
+// Caixa de busca -> filtros da API: "2023/1" (ano/semestre), "2023" (ano),
+// 5 ou mais dígitos (matrícula) ou trecho do nome.
+function filterParams(texto){
+  const f = texto.trim();
+  let m;
+  if (!f) return {};
+  if ((m = f.match(/^(\d{4})\s*\/\s*([12])$/))) return { ano: m[1], semestre: m[2] };
+  if (/^\d{4}$/.test(f)) return { ano: f };
+  if (/^\d{5,}$/.test(f)) return { matricula: f };
+  return { nome: f };
+}
+
+async function loadPage(keepSelection){
+  const params = new URLSearchParams({ ...filterParams(state.filtro), limit: PAGE_SIZE, offset: state.offset });
+  const r = await fetch(`/api/disciplinas?${params}`, { headers: { "Accept": "application/json" } });
+  if (!r.ok) throw await parseApiError(r);
+  const arr = await r.json();
+  state.rows = Array.isArray(arr) ? arr : [];
+  state.total = Number(r.headers.get("X-Total-Count")) || state.rows.length;
+  // a página ficou vazia (remoções): volta para a última que existe
+  if (!state.rows.length && state.offset > 0 && state.total > 0){
+    state.offset = Math.floor((state.total - 1) / PAGE_SIZE) * PAGE_SIZE;
+    return loadPage(keepSelection);
+  }
+  state.selectedIndex = keepSelection
+    ? Math.max(0, Math.min(state.selectedIndex, state.rows.length-1))
+    : 0;
+  renderTable();
+  renderPager();
+}
+
 async function loadAll(){
-  const arr = await apiGet("/api/disciplinas");
-  state.data = Array.isArray(arr) ? arr : [];
-  applyFilter();
+  await loadPage(true);
   // CR
   try{
     const { cr } = await apiGet("/api/cr");
-    $("#crPill").textContent = `CR: ${Number(cr).toFixed(2)}`;
+    setCR(cr);
   }catch{ /* opcional */ }
 }
 
+function goPage(dir){
+  const next = state.offset + dir * PAGE_SIZE;
+  if (next < 0 || next >= state.total) return;
+  state.offset = next;
+  loadPage().catch(err => toastDialog("erro", err.message));
+}
+
 function applyFilter(){
-  const f = state.filtro.trim().toLowerCase();
-  if (!f) state.filtered = state.data.slice();
-  else {
-    state.filtered = state.data.filter(d => {
-      const alvo = `${d.nome} ${d.matricula} ${d.ano}/${d.semestre}`.toLowerCase();
-      return alvo.includes(f);
-    });
-  }
-  state.selectedIndex = 0;
-  renderTable();
+  state.filtro = $("#filtro").value;
+  state.offset = 0;
+  loadPage().catch(err => toastDialog("erro", err.message));
+}
+
+// várias alterações seguidas (ex.: outro usuário num lote) = uma recarga
+let reloadTimer = 0;
+function schedulePageReload(){
+  if (reloadTimer) return;
+  reloadTimer = setTimeout(() => {
+    reloadTimer = 0;
+    loadPage(true).catch(() => {});
+  }, 100);
+}
+
+function setCR(cr){
+  $("#crPill").textContent = `CR: ${Number(cr).toFixed(2)}`;
+}
+
+// após uma alteração: com o feed ativo a tela já foi atualizada pelo evento
+function refresh(){
+  if (!state.live) return loadAll();
+}
+
+// ======= Feed de alterações (SSE) =======
+// Retorna false sem EventSource. Com o feed, a carga inicial é a do onopen.
+function startEvents(){
+  if (!("EventSource" in window)) return false;
+  const es = new EventSource("/api/events");
+  let loaded = false;
+  const load = () => loadAll().then(() => { loaded = true; },
+                                    err => { if (!loaded) toastDialog("erro", err.message); });
+  // (re)conectou: eventos perdidos no intervalo só aparecem recarregando
+  es.onopen = () => { state.live = true; load(); };
+  // feed indisponível antes da primeira carga: carrega assim mesmo
+  es.onerror = () => { state.live = false; if (!loaded) load(); };
+
+  // filtro, ordem e total são do servidor: recarrega a página atual
+  const changed = (e) => {
+    setCR(JSON.parse(e.data).cr);
+    schedulePageReload();
+  };
+  es.addEventListener("insert", changed);
+  es.addEventListener("update", changed);
+  es.addEventListener("remove", changed);
+  // lote ou remoção que renumerou ids: recarrega tudo
+  es.addEventListener("reset", () => { loadAll().catch(() => {}); });
+  return true;
 }
 
 // ======= Render =======
+function renderPager(){
+  const fim = state.offset + state.rows.length;
+  $("#pagerInfo").textContent = state.total
+    ? `${state.offset + 1}–${fim} de ${state.total}`
+    : "nenhuma disciplina";
+  $("#btnAnterior").disabled = state.offset === 0;
+  $("#btnProxima").disabled = fim >= state.total;
+}
+
 function renderTable(){
   const tb = $("#gridBody");
   tb.innerHTML = "";
-  state.filtered.forEach((d, idx) => {
+  state.rows.forEach((d, idx) => {
     const tr = document.createElement("tr");
     tr.setAttribute("role", "row");
     tr.setAttribute("aria-selected", idx === state.selectedIndex ? "true" : "false");
@@ -167,7 +261,7 @@ function renderTable(){
 }
 
 function selectRow(idx){
-  state.selectedIndex = Math.max(0, Math.min(idx, state.filtered.length-1));
+  state.selectedIndex = Math.max(0, Math.min(idx, state.rows.length-1));
   $$("#gridBody tr").forEach((tr,i)=>tr.setAttribute("aria-selected", i===state.selectedIndex ? "true":"false"));
 }
 
@@ -181,7 +275,7 @@ function openInsert(){
     try{
       await apiSend("POST", "/api/disciplinas", data);
       modal.close();
-      toastDialog("sucesso", "Disciplina inserida com sucesso.", () => loadAll());
+      toastDialog("sucesso", "Disciplina inserida com sucesso.", () => refresh());
     }catch(e){ modal.close(); toastDialog("erro", e.message, () => {}); }
   });
   const cancel = button("Cancelar", "ghost", () => modal.close());
@@ -200,7 +294,7 @@ function openEdit(d){
     try{
       await apiSend("PUT", `/api/disciplinas/${d.id}`, data);
       modal.close();
-      toastDialog("sucesso", "Disciplina atualizada com sucesso.", () => loadAll());
+      toastDialog("sucesso", "Disciplina atualizada com sucesso.", () => refresh());
     }catch(e){ modal.close(); toastDialog("erro", e.message, () => {}); }
   });
   const cancel = button("Cancelar", "ghost", () => modal.close());
@@ -224,7 +318,7 @@ function openRemove(d){
     try{
       await apiSend("DELETE", `/api/disciplinas/${d.id}`);
       modal.close();
-      toastDialog("sucesso", "Disciplina removida com sucesso.", () => loadAll());
+      toastDialog("sucesso", "Disciplina removida com sucesso.", () => refresh());
     }catch(e){ modal.close(); toastDialog("erro", e.message, () => {}); }
   });
   const nao = button("Não", "ghost", () => modal.close());
@@ -255,24 +349,23 @@ function setFormValues(form, d){
 }
 
 // ======= Eventos da Home =======
-$("#btnFiltrar").addEventListener("click", () => {
-  state.filtro = $("#filtro").value;
-  applyFilter();
-});
+$("#btnFiltrar").addEventListener("click", applyFilter);
 $("#filtro").addEventListener("keydown", (e) => {
-  if (e.key === "Enter"){ state.filtro = e.currentTarget.value; applyFilter(); }
+  if (e.key === "Enter") applyFilter();
 });
 $("#btnInserir").addEventListener("click", openInsert);
+$("#btnAnterior").addEventListener("click", () => goPage(-1));
+$("#btnProxima").addEventListener("click", () => goPage(1));
 
 // navegação por teclado
 $("#gridBody").addEventListener("keydown", (e) => {
-  if (!state.filtered.length) return;
+  if (e.key === "PageDown"){ goPage(1); e.preventDefault(); return; }
+  if (e.key === "PageUp"){ goPage(-1); e.preventDefault(); return; }
+  if (!state.rows.length) return;
   if (e.key === "ArrowDown"){ selectRow(state.selectedIndex + 1); ensureRowVisible(); e.preventDefault(); }
   else if (e.key === "ArrowUp"){ selectRow(state.selectedIndex - 1); ensureRowVisible(); e.preventDefault(); }
-  else if (e.key === "PageDown"){ scrollPage(1); e.preventDefault(); }
-  else if (e.key === "PageUp"){ scrollPage(-1); e.preventDefault(); }
-  else if (e.key === "Enter"){ const d = state.filtered[state.selectedIndex]; openEdit(d); e.preventDefault(); }
-  else if (e.key === "Delete"){ const d = state.filtered[state.selectedIndex]; openRemove(d); e.preventDefault(); }
+  else if (e.key === "Enter"){ const d = state.rows[state.selectedIndex]; openEdit(d); e.preventDefault(); }
+  else if (e.key === "Delete"){ const d = state.rows[state.selectedIndex]; openRemove(d); e.preventDefault(); }
 });
 // permitir foco no tbody para hotkeys
 $("#gridBody").tabIndex = 0;
@@ -289,14 +382,9 @@ function ensureRowVisible(){
   else if (rBottom > vBottom) container.scrollTop = rBottom - container.clientHeight;
 }
 
-function scrollPage(dir){
-  const container = $("#gridBody");
-  container.scrollTop += dir * container.clientHeight * 0.9;
-  const approxIndex = Math.floor(container.scrollTop / (container.scrollHeight / Math.max(state.filtered.length,1)) );
-  selectRow(approxIndex);
-}
-
 // ======= Init =======
-loadAll().catch(err => {
-  toastDialog("erro", err.message);
-});
\ No newline at end of file
+if (!startEvents()) {
+  loadAll().catch(err => {
+    toastDialog("erro", err.message);
+  });
+}
\ No newline at end of file